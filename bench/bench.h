@@ -0,0 +1,60 @@
+#pragma once
+
+#include <framework/macro_utils.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace feather::bench {
+
+// Keeps the optimizer from dropping a result nothing else reads
+template <class T>
+void keep(const T& value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+	static const void* volatile sink;
+	sink = &value;
+#else
+	asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+// Nanoseconds one call of function takes, best of repeats
+template <class F>
+double time_ns(F&& function, uint32_t repeats = 5) {
+	double best = 0.0;
+	for (uint32_t i = 0; i < repeats; ++i) {
+		const auto start = std::chrono::steady_clock::now();
+		function();
+		const double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		if (i == 0 || elapsed < best)
+			best = elapsed;
+	}
+	return best;
+}
+
+// One result line: total time and time per operation
+void report(std::string_view name, double ns, size_t operations);
+
+// Builds the database the reflection benches run against (see startup_bench.cpp)
+struct ClassDBSetup {
+	// Creates the ClassDB and registers every core type the first time;
+	// returns how long that took
+	static double setup();
+	// The numbering registration did after every class before batches existed
+	static double renumber_per_class();
+};
+
+struct Registration {
+	Registration(std::string_view name, void (*function)());
+};
+
+} // namespace feather::bench
+
+// Defines a benchmark; feather.bench runs every one whose name contains its
+// first argument (all of them without one)
+#define FBENCH(name)                                                                                                   \
+	static void name();                                                                                                \
+	static const ::feather::bench::Registration CONCAT(_bench_registration_, name)(#name, &name);                     \
+	static void name()
@@ -0,0 +1,43 @@
+#include "bench.h"
+
+#include <iostream>
+#include <print>
+#include <string_view>
+#include <vector>
+
+namespace feather::bench {
+
+namespace {
+
+struct Entry {
+	std::string_view name;
+	void (*function)();
+};
+
+// Function-local so registrations from other translation units can run first
+std::vector<Entry>& entries() {
+	static std::vector<Entry> list;
+	return list;
+}
+
+} // namespace
+
+Registration::Registration(std::string_view name, void (*function)()) {
+	entries().push_back({ name, function });
+}
+
+void report(std::string_view name, double ns, size_t operations) {
+	std::println(std::cout, "  {:<48} {:>12.3f} ms {:>12.2f} ns/op", name, ns / 1e6, ns / static_cast<double>(operations));
+}
+
+} // namespace feather::bench
+
+int main(int argc, char* argv[]) {
+	const std::string_view filter = argc > 1 ? argv[1] : "";
+	for (const auto& [name, function] : feather::bench::entries()) {
+		if (name.find(filter) == std::string_view::npos)
+			continue;
+		std::println(std::cout, "{}", name);
+		function();
+	}
+}
@@ -0,0 +1,60 @@
+#include "bench.h"
+
+#include <framework/cow_vector.h>
+#include <math/math_defs.h>
+
+#include <vector>
+
+using namespace feather;
+
+namespace {
+
+constexpr size_t vertex_count = 1'000'000;
+
+// The same small per-vertex edit in every variant, so only the access path differs
+inline void displace(Vertex& vertex) {
+	vertex.position.y += vertex.normal.y * 0.01f;
+	vertex.uv.x += 0.001f;
+}
+
+} // namespace
+
+// Mutating 1M vertices: per-access operator[] (a uniqueness check per vertex)
+// against one mutable_span write session, with std::vector as the floor
+FBENCH(cow_vector_mutate_vertices) {
+	const Vertex initial { Vector3 { 0, 1, 0 }, Vector3 { 0, 1, 0 } };
+
+	std::vector<Vertex> plain(vertex_count, initial);
+	bench::report("std::vector", bench::time_ns([&] {
+					  for (Vertex& vertex : plain) {
+						  displace(vertex);
+					  }
+				  }),
+				  vertex_count);
+	bench::keep(plain.data());
+
+	CowVector<Vertex> vertices(vertex_count, initial);
+	bench::report("CowVector operator[]", bench::time_ns([&] {
+					  for (size_t i = 0; i < vertices.size(); ++i) {
+						  displace(vertices[i]);
+					  }
+				  }),
+				  vertex_count);
+
+	bench::report("CowVector mutable_span", bench::time_ns([&] {
+					  for (Vertex& vertex : vertices.mutable_span()) {
+						  displace(vertex);
+					  }
+				  }),
+				  vertex_count);
+
+	// A renderer snapshot still shares the buffer: the session detaches once, up front
+	bench::report("CowVector mutable_span, shared", bench::time_ns([&] {
+					  const CowVector<Vertex> snapshot = vertices;
+					  for (Vertex& vertex : vertices.mutable_span()) {
+						  displace(vertex);
+					  }
+				  }),
+				  vertex_count);
+	bench::keep(vertices.data());
+}
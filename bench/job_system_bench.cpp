@@ -0,0 +1,58 @@
+#include "bench.h"
+
+#include <framework/job_system.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <format>
+#include <thread>
+#include <vector>
+
+using namespace feather;
+
+// parallel_for over a compute-bound loop from 1 core (no workers, everything
+// runs in wait) up to every hardware thread; speedup is against the 1-core run
+FBENCH(job_system_scaling) {
+	constexpr size_t count = 1 << 22;
+	constexpr size_t grain = 4096;
+	std::vector<float> values(count);
+
+	const uint32_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+	double single_core = 0.0;
+	for (uint32_t threads = 1; threads <= cores; ++threads) {
+		JobSystem jobs(static_cast<int>(threads) - 1);
+		const double ns = bench::time_ns([&] {
+			jobs.parallel_for(0, count, grain, [&values](size_t first, size_t last) {
+				for (size_t i = first; i < last; ++i) {
+					const float x = static_cast<float>(i) * 0.001f;
+					values[i] = std::sin(x) * std::cos(x * 0.5f) + std::sqrt(x);
+				}
+			});
+		});
+		bench::keep(values.data());
+		if (threads == 1)
+			single_core = ns;
+		bench::report(std::format("{:>2} cores (x{:.2f})", threads, single_core / ns), ns, count);
+	}
+}
+
+// Jobs too small to pay for themselves: measures the per-job cost of run and steal
+FBENCH(job_system_overhead) {
+	constexpr size_t count = 1 << 16;
+
+	const uint32_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+	for (uint32_t threads = 1; threads <= cores; threads *= 2) {
+		JobSystem jobs(static_cast<int>(threads) - 1);
+		std::atomic<size_t> done { 0 };
+		const double ns = bench::time_ns([&] {
+			TaskGroup group;
+			for (size_t i = 0; i < count; ++i) {
+				jobs.run(group, [&done] { done.fetch_add(1, std::memory_order_relaxed); });
+			}
+			jobs.wait(group);
+		});
+		bench::keep(done.load());
+		bench::report(std::format("{:>2} cores, empty jobs", threads), ns, count);
+	}
+}
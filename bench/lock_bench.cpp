@@ -0,0 +1,71 @@
+#include "bench.h"
+
+#include <framework/assert.h>
+#include <framework/spinlock.h>
+
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <mutex>
+#include <print>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace feather;
+
+namespace {
+
+constexpr size_t locks_per_thread = 100'000;
+
+// Every thread takes the lock locks_per_thread times around a short critical
+// section; returns the wall time of the slowest
+template <class Lock>
+double contend(Lock& lock, uint32_t threads) {
+	uint64_t counter = 0;
+	const double ns = bench::time_ns(
+			[&] {
+				std::vector<std::jthread> workers;
+				workers.reserve(threads);
+				for (uint32_t t = 0; t < threads; ++t) {
+					workers.emplace_back([&] {
+						for (size_t i = 0; i < locks_per_thread; ++i) {
+							std::scoped_lock guard(lock);
+							++counter;
+						}
+					});
+				}
+			},
+			3
+	);
+	fassert(counter == 3 * threads * locks_per_thread, "A lock let two threads in at once");
+	return ns;
+}
+
+template <class Lock>
+void run(std::string_view name) {
+	for (uint32_t threads = 2; threads <= 16; threads *= 2) {
+		Lock lock;
+		bench::report(std::format("{}, {:>2} threads", name, threads), contend(lock, threads), threads * locks_per_thread);
+	}
+}
+
+} // namespace
+
+// 2 to 16 threads hammering one lock: spinlock, adaptive_lock and std::mutex
+// for reference, then adaptive_lock's own contention counters
+FBENCH(lock_contention) {
+	run<spinlock>("spinlock");
+	run<adaptive_lock<>>("adaptive_lock");
+	run<std::mutex>("std::mutex");
+
+	for (uint32_t threads = 2; threads <= 16; threads *= 2) {
+		adaptive_lock<true> lock;
+		contend(lock, threads);
+		const lock_contention_stats& stats = lock.get_stats();
+		const uint64_t parks = stats.parks.load();
+		std::println(std::cout, "  {:>2} threads: {} acquisitions, {} contended, {} spins, {} parks ({:.0f} ns each)",
+					 threads, stats.acquisitions.load(), stats.contended.load(), stats.spins.load(), parks,
+					 parks ? static_cast<double>(stats.park_nanoseconds.load()) / static_cast<double>(parks) : 0.0);
+	}
+}
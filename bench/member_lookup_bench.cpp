@@ -0,0 +1,89 @@
+#include "bench.h"
+
+#include <framework/variant.h>
+#include <main/class_db.h>
+#include <resources/material.h>
+
+#include <format>
+#include <string_view>
+
+using namespace feather;
+
+namespace {
+
+constexpr size_t access_count = 1'000'000;
+
+// How members were found before the flattened tables: a linear scan of each
+// class's own members, then a class map lookup to climb to the parent
+const ClassInfo::Property* find_by_scan(const ClassInfo* info, std::string_view name) {
+	while (info) {
+		for (const ClassInfo::Property& property : info->properties) {
+			if (property.name == name)
+				return &property;
+		}
+		info = info->parent.size() ? ClassDB::find_class_info(info->parent) : nullptr;
+	}
+	return nullptr;
+}
+
+} // namespace
+
+// Property access on PBRMaterial (Reflected > Resource > Material >
+// PBRMaterial): its own metallic_factor and should_be_loaded, inherited from
+// Resource two levels up
+FBENCH(member_lookup) {
+	bench::ClassDBSetup::setup();
+
+	PBRMaterial material;
+	Variant object(static_cast<Reflected*>(&material));
+	const ClassInfo* info = material.get_class_info();
+
+	for (const std::string_view name : { std::string_view("metallic_factor"), std::string_view("should_be_loaded") }) {
+		const ClassInfo::Property* found = nullptr;
+		bench::report(std::format("{}: parent-chain scan", name), bench::time_ns([&] {
+						  for (size_t i = 0; i < access_count; ++i) {
+							  found = find_by_scan(info, name);
+							  bench::keep(found);
+						  }
+					  }),
+					  access_count);
+
+		// The probe alone; Variant::get below also hashes the name
+		const StaticString key(name);
+		bench::report(std::format("{}: flattened table", name), bench::time_ns([&] {
+						  for (size_t i = 0; i < access_count; ++i) {
+							  found = info->property_table.find(key);
+							  bench::keep(found);
+						  }
+					  }),
+					  access_count);
+
+		bench::report(std::format("{}: Variant::get", name), bench::time_ns([&] {
+						  for (size_t i = 0; i < access_count; ++i) {
+							  bench::keep(object.get(name));
+						  }
+					  }),
+					  access_count);
+
+		const PropertyHandle handle = ClassDB::resolve_property(PBRMaterial::get_class_static(), name);
+		bench::report(std::format("{}: PropertyHandle::get", name), bench::time_ns([&] {
+						  for (size_t i = 0; i < access_count; ++i) {
+							  bench::keep(handle.get(&material));
+						  }
+					  }),
+					  access_count);
+	}
+
+	bench::report("metallic_factor: Variant::set", bench::time_ns([&] {
+					  for (size_t i = 0; i < access_count; ++i) {
+						  object.set("metallic_factor", Variant(0.5f));
+					  }
+				  }),
+				  access_count);
+	bench::report("get_rid (Resource): Variant::call", bench::time_ns([&] {
+					  for (size_t i = 0; i < access_count; ++i) {
+						  bench::keep(object.call("get_rid"));
+					  }
+				  }),
+				  access_count);
+}
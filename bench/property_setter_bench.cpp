@@ -0,0 +1,68 @@
+#include "bench.h"
+
+#include <framework/variant.h>
+#include <main/class_db.h>
+#include <main/member_handle.h>
+#include <resources/material.h>
+
+#include <format>
+#include <string_view>
+#include <utility>
+
+using namespace feather;
+
+namespace {
+
+constexpr size_t set_count = 1'000'000;
+
+// The setter thunk body before get_unchecked: convert through as<U>() and
+// format the mismatch message whether or not it's needed
+template <class U, auto Setter>
+void setter_before(void* object, const Variant& value) {
+	auto result = value.as<U>();
+	fassert(result.has_value(),
+			std::format("Property setter expected Variant type {} and got {}",
+						std::to_underlying(get_variant_type<U>()),
+						std::to_underlying(value.get_type())));
+	(static_cast<PBRMaterial*>(object)->*Setter)(std::move(result.value()));
+}
+
+void compare(PBRMaterial& material, std::string_view name, void (*before)(void*, const Variant&), const Variant& value) {
+	const ClassInfo::Property* property = material.get_class_info()->property_table.find(StaticString(name));
+	fassert(property && property->setter, std::format("No setter for {}", name));
+
+	bench::report(std::format("{}: thunk before", name), bench::time_ns([&] {
+					  for (size_t i = 0; i < set_count; ++i) {
+						  before(&material, value);
+					  }
+				  }),
+				  set_count);
+	bench::report(std::format("{}: thunk after", name), bench::time_ns([&] {
+					  for (size_t i = 0; i < set_count; ++i) {
+						  property->setter(&material, value);
+					  }
+				  }),
+				  set_count);
+
+	const PropertyHandle handle = ClassDB::resolve_property(PBRMaterial::get_class_static(), name);
+	bench::report(std::format("{}: PropertyHandle::set", name), bench::time_ns([&] {
+					  for (size_t i = 0; i < set_count; ++i) {
+						  handle.set(&material, value);
+					  }
+				  }),
+				  set_count);
+}
+
+} // namespace
+
+// Property setter throughput on PBRMaterial, through the generated thunk and
+// through the thunk as it was written before get_unchecked
+FBENCH(property_setter) {
+	bench::ClassDBSetup::setup();
+
+	PBRMaterial material;
+	compare(material, "metallic_factor", &setter_before<float, &PBRMaterial::set_metallic_factor>, Variant(0.5f));
+	compare(material, "base_color_factor", &setter_before<Color, &PBRMaterial::set_base_color_factor>,
+			Variant(Color(0.2f, 0.4f, 0.6f, 1.0f)));
+	bench::keep(material.get_metallic_factor());
+}
@@ -0,0 +1,72 @@
+#include "bench.h"
+
+#include <framework/assert.h>
+#include <framework/io_executor.h>
+#include <framework/job_system.h>
+#include <main/project_settings.h>
+#include <resources/mesh.h>
+#include <resources/mesh_format_loader.h>
+#include <resources/resource_loader.h>
+
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <thread>
+
+using namespace feather;
+
+namespace {
+
+constexpr const char* quad_obj = "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nf 1 2 3\nf 1 3 4\n";
+
+} // namespace
+
+// Two load_async calls and a load() of the same mesh at once, polled from this
+// thread the way a frame would, with no workers and with one. All three must
+// get the one filled resource.
+FBENCH(resource_load_async) {
+	bench::ClassDBSetup::setup();
+	ProjectSettings project_settings;
+	ResourceLoader resource_loader;
+	resource_loader.add_resource_format_loader(std::make_shared<MeshFormatLoader>());
+
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "feather_bench";
+	std::filesystem::create_directories(directory);
+
+	for (const int workers : { 0, 1 }) {
+		JobSystem jobs(workers);
+		// Destroyed first: it resumes coroutines through the JobSystem
+		IoExecutor io(1);
+
+		// A new file each time, so nothing comes from the cache
+		const Path path = directory / std::format("quad_{}.obj", workers);
+		std::ofstream(path) << quad_obj;
+
+		std::shared_ptr<ComplexMesh> first_mesh, second_mesh, sync_mesh;
+		const double ns = bench::time_ns(
+				[&] {
+					Task<std::shared_ptr<ComplexMesh>> first = resource_loader.load_async<ComplexMesh>(path);
+					Task<std::shared_ptr<ComplexMesh>> second = resource_loader.load_async<ComplexMesh>(path);
+					first.start();
+					second.start();
+					// Waits for the load first started rather than decoding again
+					sync_mesh = resource_loader.load<ComplexMesh>(path);
+					while (!first.is_done() || !second.is_done()) {
+						jobs.run_pending();
+						std::this_thread::yield();
+					}
+					first_mesh = first.get_result();
+					second_mesh = second.get_result();
+				},
+				1
+		);
+
+		fassert(first_mesh && first_mesh == second_mesh && first_mesh == sync_mesh,
+				"Loads of one path returned different resources");
+		fassert(first_mesh->is_loaded() && first_mesh->get_indices().size() == 6, "Mesh wasn't filled");
+		bench::report(std::format("{} workers: 2 async + 1 sync load of one mesh", workers), ns, 1);
+	}
+
+	std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,175 @@
+#include "bench.h"
+
+#include <framework/assert.h>
+#include <framework/ring_queue.h>
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <format>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace feather;
+
+namespace {
+
+constexpr size_t item_count = 1 << 20;
+constexpr size_t queue_capacity = 1024;
+constexpr size_t batch_size = 64;
+
+// Items carry their producer in the top bits and a per-producer sequence
+// number below, so the consumer can check nothing got lost or reordered
+constexpr uint64_t make_item(uint32_t producer, uint64_t sequence) {
+	return (uint64_t(producer) << 48) | sequence;
+}
+
+class OrderCheck {
+	std::array<uint64_t, 16> _next {};
+
+public:
+	void operator()(uint64_t item) {
+		uint64_t& next = _next[item >> 48];
+		fassert((item & ((uint64_t(1) << 48) - 1)) == next, "Queue lost or reordered an item");
+		++next;
+	}
+};
+
+// The hand-off the queues replace: a deque behind a mutex, with a condition
+// variable to wake the consumer
+class LockedQueue {
+	std::mutex _mutex;
+	std::condition_variable _ready;
+	std::deque<uint64_t> _items;
+
+public:
+	void push(uint64_t item) {
+		{
+			std::scoped_lock lock(_mutex);
+			_items.push_back(item);
+		}
+		_ready.notify_one();
+	}
+
+	uint64_t wait_pop() {
+		std::unique_lock lock(_mutex);
+		_ready.wait(lock, [this] { return !_items.empty(); });
+		const uint64_t item = _items.front();
+		_items.pop_front();
+		return item;
+	}
+};
+
+// Splits item_count among producers, each calling push(producer, sequence),
+// while this thread consumes through pop(check) until every item arrived
+template <class Push, class Consume>
+double hand_off(uint32_t producers, Push&& push, Consume&& consume) {
+	return bench::time_ns(
+			[&] {
+				std::vector<std::jthread> threads;
+				threads.reserve(producers);
+				for (uint32_t p = 0; p < producers; ++p) {
+					threads.emplace_back([&push, p, count = item_count / producers] {
+						for (uint64_t i = 0; i < count; ++i) {
+							push(make_item(p, i));
+						}
+					});
+				}
+				OrderCheck check;
+				consume(item_count / producers * producers, check);
+			},
+			3
+	);
+}
+
+void report(std::string_view name, uint32_t producers, double ns) {
+	bench::report(std::format("{}, {} producer{}", name, producers, producers > 1 ? "s" : ""), ns, item_count);
+}
+
+void bench_locked(uint32_t producers) {
+	LockedQueue queue;
+	report("mutex/cv deque", producers,
+		   hand_off(producers, [&](uint64_t item) { queue.push(item); }, [&](size_t count, OrderCheck& check) {
+			   for (size_t i = 0; i < count; ++i) {
+				   check(queue.wait_pop());
+			   }
+		   }));
+}
+
+template <class Queue>
+void push_spinning(Queue& queue, uint64_t item) {
+	while (!queue.try_push(item)) {
+		std::this_thread::yield();
+	}
+}
+
+// Blocks for the first item, then takes whatever else is ready in one go
+template <class Queue>
+void consume_batched(Queue& queue, size_t count, OrderCheck& check) {
+	std::array<uint64_t, batch_size> items;
+	for (size_t received = 0; received < count;) {
+		queue.wait_pop(items[0]);
+		const size_t popped = 1 + queue.try_pop_batch(std::span(items).subspan(1));
+		for (size_t i = 0; i < popped; ++i) {
+			check(items[i]);
+		}
+		received += popped;
+	}
+}
+
+} // namespace
+
+// Throughput of a 1M item hand-off to one consumer: the mutex/cv deque the
+// render thread used, SpscQueue one at a time and in batches, and MpscQueue
+// with several producers
+FBENCH(ring_queue_throughput) {
+	bench_locked(1);
+
+	{
+		SpscQueue<uint64_t> queue(queue_capacity);
+		report("SpscQueue", 1,
+			   hand_off(1, [&](uint64_t item) { push_spinning(queue, item); }, [&](size_t count, OrderCheck& check) {
+				   uint64_t item;
+				   for (size_t i = 0; i < count; ++i) {
+					   queue.wait_pop(item);
+					   check(item);
+				   }
+			   }));
+	}
+
+	{
+		SpscQueue<uint64_t> queue(queue_capacity);
+		std::array<uint64_t, batch_size> pending;
+		size_t pending_count = 0;
+		report("SpscQueue, 64-item batches", 1,
+			   hand_off(
+					   1,
+					   [&](uint64_t item) {
+						   pending[pending_count++] = item;
+						   // item_count is a multiple of batch_size, so nothing is left over
+						   if (pending_count < batch_size)
+							   return;
+						   for (std::span<uint64_t> rest(pending); !rest.empty();) {
+							   const size_t pushed = queue.try_push_batch(rest);
+							   if (pushed == 0)
+								   std::this_thread::yield();
+							   rest = rest.subspan(pushed);
+						   }
+						   pending_count = 0;
+					   },
+					   [&](size_t count, OrderCheck& check) { consume_batched(queue, count, check); }
+			   ));
+	}
+
+	for (uint32_t producers = 2; producers <= 8; producers *= 2) {
+		bench_locked(producers);
+		MpscQueue<uint64_t> queue(queue_capacity);
+		report("MpscQueue", producers,
+			   hand_off(producers, [&](uint64_t item) { push_spinning(queue, item); },
+						[&](size_t count, OrderCheck& check) { consume_batched(queue, count, check); }));
+	}
+}
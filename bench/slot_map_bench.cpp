@@ -0,0 +1,82 @@
+#include "bench.h"
+
+#include <framework/slot_map.h>
+#include <framework/static_indexed_array.h>
+
+#include <cstdint>
+#include <format>
+#include <random>
+#include <vector>
+
+using namespace feather;
+
+namespace {
+
+constexpr size_t element_count = 1 << 16;
+// Elements replaced by each churn pass
+constexpr size_t churn_count = element_count / 2;
+
+struct Listener {
+	uint64_t payload[4];
+};
+
+// Adds element_count listeners, removing every other one right away, so the
+// container has holes (StaticIndexedArray) or reused slots (SlotMap) as after churn
+template <class TContainer>
+auto fill_and_thin(TContainer& container) {
+	using Id = decltype(container.add(Listener {}));
+	std::vector<Id> ids;
+	for (size_t i = 0; i < element_count; ++i) {
+		const Id id = container.add(Listener { { i, i, i, i } });
+		if (i % 2)
+			container.remove(id);
+		else
+			ids.push_back(id);
+	}
+	return ids;
+}
+
+// Removes and re-adds churn_count random elements, like listeners coming and going
+template <class TContainer, class TId>
+void churn(TContainer& container, std::vector<TId>& ids, std::mt19937& random) {
+	for (size_t i = 0; i < churn_count; ++i) {
+		const size_t pick = random() % ids.size();
+		container.remove(ids[pick]);
+		ids[pick] = container.add(Listener { { i, i, i, i } });
+	}
+}
+
+template <class TContainer>
+void run(std::string_view name) {
+	TContainer container;
+	auto ids = fill_and_thin(container);
+	std::mt19937 random(42);
+
+	bench::report(std::format("{} churn", name), bench::time_ns([&] { churn(container, ids, random); }), churn_count);
+
+	uint64_t sum = 0;
+	const double iterate = bench::time_ns([&] {
+		for (const Listener& listener : container) {
+			sum += listener.payload[0];
+		}
+	});
+	bench::keep(sum);
+	bench::report(std::format("{} iterate", name), iterate, container.size());
+
+	const double lookup = bench::time_ns([&] {
+		for (const auto id : ids) {
+			sum += container[id].payload[1];
+		}
+	});
+	bench::keep(sum);
+	bench::report(std::format("{} lookup", name), lookup, ids.size());
+}
+
+} // namespace
+
+// Delegate-listener churn: StaticIndexedArray (lowest free index, holes on
+// iteration) against SlotMap (free list through the slots, packed values)
+FBENCH(slot_map_vs_static_indexed_array) {
+	run<StaticIndexedArray<Listener>>("StaticIndexedArray");
+	run<SlotMap<Listener>>("SlotMap");
+}
@@ -0,0 +1,52 @@
+#include "bench.h"
+
+#include <main/class_db.h>
+
+#include <framework/register_framework_types.gen.h>
+#include <main/register_main_types.gen.h>
+#include <math/register_math_types.gen.h>
+#include <rendering/register_rendering_types.gen.h>
+#include <resources/register_resources_types.gen.h>
+#include <world/register_world_types.gen.h>
+
+namespace feather::bench {
+
+double ClassDBSetup::setup() {
+	// Registration only happens once per process (get_class_info caches point
+	// into the database), so it is timed once, the way Main::setup_db runs it
+	static const double ns = time_ns(
+			[] {
+				// Lives for the process, like Main's
+				ClassDB::create_for_bench();
+				ClassDB::RegistrationBatch batch;
+				register_framework_types();
+				register_math_types();
+				register_resources_types();
+				register_rendering_types();
+				register_world_types();
+				register_main_types();
+			},
+			1
+	);
+	return ns;
+}
+
+double ClassDBSetup::renumber_per_class() {
+	const size_t classes = ClassDB::get_class_count();
+	return time_ns([classes] {
+		for (size_t i = 0; i < classes; ++i) {
+			ClassDB::renumber_class_ids();
+		}
+	});
+}
+
+} // namespace feather::bench
+
+using namespace feather;
+
+FBENCH(class_registration) {
+	const double ns = bench::ClassDBSetup::setup();
+	const size_t classes = ClassDB::get_class_count();
+	bench::report("register core types, one batch", ns, classes);
+	bench::report("renumbering after every class", bench::ClassDBSetup::renumber_per_class(), classes);
+}
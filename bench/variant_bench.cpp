@@ -0,0 +1,89 @@
+#include "bench.h"
+
+#include <framework/callable.h>
+#include <framework/variant.h>
+#include <framework/variant_array.h>
+
+#include <format>
+#include <iostream>
+#include <print>
+#include <span>
+#include <string>
+#include <utility>
+
+using namespace feather;
+
+namespace {
+
+constexpr size_t call_count = 1'000'000;
+constexpr size_t element_count = 1'000'000;
+
+real_t scale(real_t value, int factor, real_t offset) {
+	return value * static_cast<real_t>(factor) + offset;
+}
+
+size_t length_of(std::string text) {
+	return text.size();
+}
+
+} // namespace
+
+// Variant layout: its size, Callable::call argument marshalling, and a
+// VariantArray scan. Compare against a build of the previous layout.
+FBENCH(variant_layout) {
+	std::println(std::cout, "  sizeof(Variant) = {}, sizeof(Callable) = {}", sizeof(Variant), sizeof(Callable));
+
+	// The baseline: the same function called directly, through a pointer the
+	// optimizer can't see through so the call isn't inlined or folded
+	real_t (*volatile direct_scale)(real_t, int, real_t) = &scale;
+	real_t scaled = 0;
+	const double direct_ns = bench::time_ns([&] {
+		for (size_t i = 0; i < call_count; ++i) {
+			scaled += direct_scale(real_t(1.5), 3, real_t(0.25));
+		}
+	});
+	bench::report("direct call (real_t, int, real_t)", direct_ns, call_count);
+
+	const Callable scale_callable(&scale);
+	Variant scale_args[] = { Variant(real_t(1.5)), Variant(3), Variant(real_t(0.25)) };
+	const double callable_ns = bench::time_ns([&] {
+		for (size_t i = 0; i < call_count; ++i) {
+			scaled += scale_callable.call(std::span<Variant>(scale_args)).get_unchecked<real_t>();
+		}
+	});
+	bench::report("Callable::call (real_t, int, real_t)", callable_ns, call_count);
+	bench::keep(scaled);
+	std::println(std::cout, "  Callable::call overhead: {:.2f} ns/call",
+				 (callable_ns - direct_ns) / static_cast<double>(call_count));
+
+	// Boxed payload: the argument is copied out of its box for every call
+	const Callable length_callable(&length_of);
+	Variant length_args[] = { Variant(std::string("a string too long for small-string storage")) };
+	size_t lengths = 0;
+	bench::report("Callable::call (std::string)", bench::time_ns([&] {
+					  for (size_t i = 0; i < call_count; ++i) {
+						  lengths += length_callable.call(std::span<Variant>(length_args)).get_unchecked<size_t>();
+					  }
+				  }),
+				  call_count);
+	bench::keep(lengths);
+
+	VariantArray array;
+	for (size_t i = 0; i < element_count; ++i) {
+		if (i % 2)
+			array.push_back(Variant(static_cast<int>(i)));
+		else
+			array.push_back(Variant(static_cast<real_t>(i)));
+	}
+	real_t sum = 0;
+	bench::report("VariantArray iteration (int / real_t)", bench::time_ns([&] {
+					  for (const Variant& value : std::as_const(array)) {
+						  if (value.is_type(VariantType::INT))
+							  sum += static_cast<real_t>(value.get_unchecked<int>());
+						  else
+							  sum += value.get_unchecked<real_t>();
+					  }
+				  }),
+				  element_count);
+	bench::keep(sum);
+}
@@ -0,0 +1,299 @@
+#include "alloc_tracker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <format>
+#include <new>
+
+namespace feather {
+
+namespace {
+
+constexpr size_t tag_count = static_cast<size_t>(AllocTag::count);
+
+thread_local AllocTag tls_tag = AllocTag::untagged;
+
+// One per tag, plus the total. Padded so threads charging different tags don't share lines.
+struct alignas(64) Counters {
+	std::atomic<uint64_t> allocations { 0 };
+	std::atomic<uint64_t> frees { 0 };
+	std::atomic<uint64_t> bytes_allocated { 0 };
+	std::atomic<uint64_t> live_bytes { 0 };
+	std::atomic<uint64_t> peak_bytes { 0 };
+	std::atomic<uint64_t> frame_peak_bytes { 0 };
+
+	// Cumulative values when the current frame began, and the last frame's results
+	uint64_t frame_start_allocations = 0;
+	uint64_t frame_start_bytes = 0;
+	std::atomic<uint64_t> last_frame_allocations { 0 };
+	std::atomic<uint64_t> last_frame_bytes { 0 };
+	std::atomic<uint64_t> last_frame_peak_bytes { 0 };
+};
+
+// Constant-initialized, so usable by allocations made before main
+Counters counters[tag_count + 1];
+
+void raise_to(std::atomic<uint64_t>& peak, uint64_t value) {
+	uint64_t current = peak.load(std::memory_order_relaxed);
+	while (current < value && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+	}
+}
+
+void charge(Counters& c, size_t bytes) {
+	c.allocations.fetch_add(1, std::memory_order_relaxed);
+	c.bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+	const uint64_t live = c.live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+	raise_to(c.peak_bytes, live);
+	raise_to(c.frame_peak_bytes, live);
+}
+
+void release(Counters& c, size_t bytes) {
+	c.frees.fetch_add(1, std::memory_order_relaxed);
+	c.live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+AllocTracker::Stats read(const Counters& c) {
+	return AllocTracker::Stats { .allocations = c.allocations.load(std::memory_order_relaxed),
+								 .frees = c.frees.load(std::memory_order_relaxed),
+								 .live_bytes = c.live_bytes.load(std::memory_order_relaxed),
+								 .peak_bytes = c.peak_bytes.load(std::memory_order_relaxed),
+								 .frame_allocations = c.last_frame_allocations.load(std::memory_order_relaxed),
+								 .frame_bytes = c.last_frame_bytes.load(std::memory_order_relaxed),
+								 .frame_peak_bytes = c.last_frame_peak_bytes.load(std::memory_order_relaxed) };
+}
+
+} // namespace
+
+std::string_view to_string(AllocTag tag) {
+	switch (tag) {
+	case AllocTag::untagged:
+		return "untagged";
+	case AllocTag::framework:
+		return "framework";
+	case AllocTag::resources:
+		return "resources";
+	case AllocTag::rendering:
+		return "rendering";
+	case AllocTag::world:
+		return "world";
+	case AllocTag::reflection:
+		return "reflection";
+	case AllocTag::permanent:
+		return "permanent";
+	default:
+		return "unknown";
+	}
+}
+
+AllocTagScope::AllocTagScope(AllocTag tag) : _previous(tls_tag) {
+	tls_tag = tag;
+}
+
+AllocTagScope::~AllocTagScope() {
+	tls_tag = _previous;
+}
+
+AllocTag AllocTagScope::get_current() {
+	return tls_tag;
+}
+
+AllocTracker::Stats AllocTracker::get_stats(AllocTag tag) {
+	return read(counters[static_cast<size_t>(tag)]);
+}
+
+AllocTracker::Stats AllocTracker::get_total() {
+	return read(counters[tag_count]);
+}
+
+void AllocTracker::begin_frame() {
+	for (Counters& c : counters) {
+		const uint64_t allocations = c.allocations.load(std::memory_order_relaxed);
+		const uint64_t bytes = c.bytes_allocated.load(std::memory_order_relaxed);
+		c.last_frame_allocations.store(allocations - c.frame_start_allocations, std::memory_order_relaxed);
+		c.last_frame_bytes.store(bytes - c.frame_start_bytes, std::memory_order_relaxed);
+		c.frame_start_allocations = allocations;
+		c.frame_start_bytes = bytes;
+		c.last_frame_peak_bytes.store(
+				c.frame_peak_bytes.exchange(c.live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed),
+				std::memory_order_relaxed
+		);
+	}
+}
+
+void AllocTracker::report_leaks(std::ostream& out) {
+	if constexpr (!is_enabled())
+		return;
+
+	const Stats total = get_total();
+	const Stats permanent = get_stats(AllocTag::permanent);
+	const uint64_t leaked = (total.allocations - total.frees) - (permanent.allocations - permanent.frees);
+	if (leaked == 0) {
+		out << "AllocTracker: no allocation left at shutdown\n";
+		return;
+	}
+
+	out << std::format("AllocTracker: {} allocations ({} bytes) left at shutdown\n",
+					   leaked,
+					   total.live_bytes - permanent.live_bytes);
+	for (size_t i = 0; i < tag_count; ++i) {
+		const Stats stats = read(counters[i]);
+		if (static_cast<AllocTag>(i) == AllocTag::permanent || stats.allocations == stats.frees)
+			continue;
+		out << std::format("  {:<10} {:>8} allocations {:>12} bytes (peak {} bytes)\n",
+						   to_string(static_cast<AllocTag>(i)),
+						   stats.allocations - stats.frees,
+						   stats.live_bytes,
+						   stats.peak_bytes);
+	}
+}
+
+void AllocTracker::on_allocate(AllocTag tag, size_t bytes) {
+	charge(counters[static_cast<size_t>(tag)], bytes);
+	charge(counters[tag_count], bytes);
+}
+
+void AllocTracker::on_free(AllocTag tag, size_t bytes) {
+	release(counters[static_cast<size_t>(tag)], bytes);
+	release(counters[tag_count], bytes);
+}
+
+namespace {
+
+class PermanentResource final : public std::pmr::memory_resource {
+	void* do_allocate(size_t bytes, size_t alignment) override {
+		AllocTagScope tag { AllocTag::permanent };
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+	void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+		std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+	}
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+} // namespace
+
+std::pmr::memory_resource* get_permanent_memory_resource() {
+	static PermanentResource resource;
+	return &resource;
+}
+
+} // namespace feather
+
+#ifdef FEATHER_TRACK_ALLOCATIONS
+
+// Global operator new/delete replacements. Each block starts with a header
+// recording its size and tag, so a free is charged to the tag that allocated
+// it. Everything goes through malloc/free, which sanitizer runtimes intercept,
+// so the replacement also works in enable_sanitizers builds.
+namespace {
+
+struct alignas(16) AllocHeader {
+	uint64_t size;
+	// From the start of the malloc'd block to the user pointer
+	uint32_t offset;
+	feather::AllocTag tag;
+};
+static_assert(sizeof(AllocHeader) == 16);
+
+AllocHeader* header_of(void* p) {
+	return static_cast<AllocHeader*>(p) - 1;
+}
+
+void* tracked_allocate(size_t size, size_t alignment) noexcept {
+	alignment = std::max(alignment, alignof(AllocHeader));
+	// Room for the header, then enough to align the user pointer
+	const size_t padding = sizeof(AllocHeader) + (alignment > alignof(std::max_align_t) ? alignment : 0);
+	auto* base = static_cast<std::byte*>(std::malloc(size + padding));
+	if (!base)
+		return nullptr;
+
+	const auto address = reinterpret_cast<uintptr_t>(base) + sizeof(AllocHeader);
+	auto* p = reinterpret_cast<std::byte*>((address + alignment - 1) & ~(uintptr_t(alignment) - 1));
+
+	const feather::AllocTag tag = feather::AllocTagScope::get_current();
+	*header_of(p) = AllocHeader { .size = size, .offset = static_cast<uint32_t>(p - base), .tag = tag };
+	feather::AllocTracker::on_allocate(tag, size);
+	return p;
+}
+
+void* tracked_allocate_or_throw(size_t size, size_t alignment) {
+	void* p = tracked_allocate(size, alignment);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+void tracked_free(void* p) noexcept {
+	if (!p)
+		return;
+	const AllocHeader header = *header_of(p);
+	feather::AllocTracker::on_free(header.tag, header.size);
+	std::free(static_cast<std::byte*>(p) - header.offset);
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+	return tracked_allocate_or_throw(size, alignof(std::max_align_t));
+}
+void* operator new[](size_t size) {
+	return tracked_allocate_or_throw(size, alignof(std::max_align_t));
+}
+void* operator new(size_t size, std::align_val_t alignment) {
+	return tracked_allocate_or_throw(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+	return tracked_allocate_or_throw(size, static_cast<size_t>(alignment));
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+	return tracked_allocate(size, alignof(std::max_align_t));
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+	return tracked_allocate(size, alignof(std::max_align_t));
+}
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	return tracked_allocate(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	return tracked_allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept {
+	tracked_free(p);
+}
+void operator delete[](void* p) noexcept {
+	tracked_free(p);
+}
+void operator delete(void* p, size_t) noexcept {
+	tracked_free(p);
+}
+void operator delete[](void* p, size_t) noexcept {
+	tracked_free(p);
+}
+void operator delete(void* p, std::align_val_t) noexcept {
+	tracked_free(p);
+}
+void operator delete[](void* p, std::align_val_t) noexcept {
+	tracked_free(p);
+}
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+	tracked_free(p);
+}
+void operator delete[](void* p, size_t, std::align_val_t) noexcept {
+	tracked_free(p);
+}
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+	tracked_free(p);
+}
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+	tracked_free(p);
+}
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+	tracked_free(p);
+}
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+	tracked_free(p);
+}
+
+#endif
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <ostream>
+#include <string_view>
+
+namespace feather {
+
+// Subsystem heap allocations are charged to
+enum class AllocTag : uint8_t {
+	untagged,
+	framework,
+	resources,
+	rendering,
+	world,
+	reflection,
+	// Kept on purpose until exit (intern table, profiler buffers, never-destroyed
+	// pools); not reported as leaks
+	permanent,
+	count
+};
+
+std::string_view to_string(AllocTag tag);
+
+// Charges the calling thread's allocations to a tag until the scope ends.
+// Scopes nest. Never keep one across a co_await: the coroutine may resume on
+// another thread.
+class AllocTagScope {
+public:
+	explicit AllocTagScope(AllocTag tag);
+	~AllocTagScope();
+
+	AllocTagScope(const AllocTagScope&) = delete;
+	AllocTagScope& operator=(const AllocTagScope&) = delete;
+
+	static AllocTag get_current();
+
+private:
+	AllocTag _previous;
+};
+
+// Counts global operator new/delete traffic by AllocTag. Opt-in: the operators
+// are only replaced in builds with FEATHER_TRACK_ALLOCATIONS (xmake option
+// track_allocations); otherwise every counter stays at zero. Memory that
+// libraries get from malloc directly isn't seen.
+class AllocTracker {
+public:
+	struct Stats {
+		uint64_t allocations = 0;
+		uint64_t frees = 0;
+		uint64_t live_bytes = 0;
+		uint64_t peak_bytes = 0;
+		// Over the last completed frame (see begin_frame)
+		uint64_t frame_allocations = 0;
+		uint64_t frame_bytes = 0;
+		uint64_t frame_peak_bytes = 0;
+	};
+
+	static constexpr bool is_enabled() {
+#ifdef FEATHER_TRACK_ALLOCATIONS
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	static Stats get_stats(AllocTag tag);
+	// Sum over every tag
+	static Stats get_total();
+
+	// Closes the current frame's counters and starts the next frame's; call once per frame
+	static void begin_frame();
+
+	// Prints what is still allocated, by tag, leaving out AllocTag::permanent.
+	// Meant for the very end of main.
+	static void report_leaks(std::ostream& out);
+
+	// Used by the operator new/delete replacements
+	static void on_allocate(AllocTag tag, size_t bytes);
+	static void on_free(AllocTag tag, size_t bytes);
+};
+
+// Upstream for pools and arenas that hold on to their memory until exit:
+// charges whatever they take to AllocTag::permanent
+std::pmr::memory_resource* get_permanent_memory_resource();
+
+} // namespace feather
@@ -0,0 +1,390 @@
+#include "binary_serializer.h"
+
+#include "class_info.h"
+#include "reflected.h"
+#include <main/class_db.h>
+
+#include <bit>
+#include <cstring>
+#include <fstream>
+
+namespace feather {
+
+// PODs and raw blocks are copied as they are in memory
+static_assert(std::endian::native == std::endian::little, "The binary format needs byte swapping on big-endian hosts");
+
+namespace {
+
+constexpr char magic[4] = { 'F', 'B', 'I', 'N' };
+constexpr uint8_t format_version = 1;
+// Deeper nesting than this is treated as malformed instead of exhausting the stack
+constexpr uint32_t max_depth = 256;
+
+constexpr uint64_t zigzag_encode(int64_t value) {
+	return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+constexpr int64_t zigzag_decode(uint64_t value) {
+	return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+} // namespace
+
+// Writer
+
+BinaryWriter::BinaryWriter() {
+	_write_bytes(magic, sizeof(magic));
+	_write_pod(format_version);
+	_write_pod(static_cast<uint8_t>(sizeof(real_t)));
+}
+
+bool BinaryWriter::save(const Path& path) const {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char*>(_buffer.data()), static_cast<std::streamsize>(_buffer.size()));
+	return file.good();
+}
+
+void BinaryWriter::_write_bytes(const void* data, size_t size) {
+	const std::byte* bytes = static_cast<const std::byte*>(data);
+	_buffer.insert(_buffer.end(), bytes, bytes + size);
+}
+
+void BinaryWriter::_write_varint(uint64_t value) {
+	for (; value >= 0x80; value >>= 7) {
+		_buffer.push_back(static_cast<std::byte>(value | 0x80));
+	}
+	_buffer.push_back(static_cast<std::byte>(value));
+}
+
+template <class T>
+void BinaryWriter::_write_pod(const T& value) {
+	static_assert(std::is_trivially_copyable_v<T>);
+	_write_bytes(&value, sizeof(T));
+}
+
+void BinaryWriter::_write_string(std::string_view str) {
+	_write_varint(str.size());
+	_write_bytes(str.data(), str.size());
+}
+
+template <class T>
+void BinaryWriter::_write_packed(const CowVector<T>& array) {
+	_write_varint(array.size());
+	// Aligned within the stream, so a mapped stream can be read in place
+	_buffer.resize((_buffer.size() + alignof(T) - 1) / alignof(T) * alignof(T));
+	_write_bytes(array.data(), array.size() * sizeof(T));
+}
+
+void BinaryWriter::write_object(Reflected* object) {
+	write_variant(Variant(object));
+}
+
+void BinaryWriter::write_variant(const Variant& value) {
+	_write_pod(value.get_type());
+
+	switch (value.get_type()) {
+	case VariantType::NIL:
+		break;
+	case VariantType::BOOL:
+		_write_pod(static_cast<uint8_t>(value.get_unchecked<bool>()));
+		break;
+	case VariantType::INT:
+		_write_varint(zigzag_encode(value.get_unchecked<int>()));
+		break;
+	case VariantType::FLOAT:
+		_write_pod(value.get_unchecked<real_t>());
+		break;
+	case VariantType::VECTOR3:
+		_write_pod(value.get_unchecked<Vector3>());
+		break;
+	case VariantType::VECTOR2:
+		_write_pod(value.get_unchecked<Vector2>());
+		break;
+	case VariantType::VERTEX:
+		_write_pod(value.get_unchecked<Vertex>());
+		break;
+	case VariantType::COLOR:
+		_write_pod(value.get_unchecked<Color>());
+		break;
+	case VariantType::RID:
+		_write_varint(value.get_unchecked<RID>().id);
+		break;
+	case VariantType::STRING:
+		_write_string(value.get_unchecked<std::string>());
+		break;
+	case VariantType::ARRAY: {
+		const VariantArray& array = value.get_unchecked<VariantArray>();
+		_write_varint(array.size());
+		for (const Variant& element : array) {
+			write_variant(element);
+		}
+		break;
+	}
+	case VariantType::PATH: {
+		const std::u8string path = value.get_unchecked<Path>().u8string();
+		_write_string(std::string_view(reinterpret_cast<const char*>(path.data()), path.size()));
+		break;
+	}
+	case VariantType::PACKED_BYTE_ARRAY:
+		_write_packed(value.get_unchecked<PackedByteArray>());
+		break;
+	case VariantType::PACKED_INT32_ARRAY:
+		_write_packed(value.get_unchecked<PackedInt32Array>());
+		break;
+	case VariantType::PACKED_FLOAT32_ARRAY:
+		_write_packed(value.get_unchecked<PackedFloat32Array>());
+		break;
+	case VariantType::PACKED_VECTOR3_ARRAY:
+		_write_packed(value.get_unchecked<PackedVector3Array>());
+		break;
+	case VariantType::PACKED_VERTEX_ARRAY:
+		_write_packed(value.get_unchecked<PackedVertexArray>());
+		break;
+	case VariantType::OBJECT: {
+		// 0 is null, otherwise the object id + 1; an id not seen yet is followed by its record
+		Reflected* object = value.get_unchecked<Reflected*>();
+		if (!object) {
+			_write_varint(0);
+			break;
+		}
+		auto [it, inserted] = _object_ids.try_emplace(object, _object_ids.size());
+		_write_varint(it->second + 1);
+		if (inserted)
+			_write_object_record(object);
+		break;
+	}
+	default:
+		// A bare tag would leave the stream unreadable
+		fassert(false, "Variant type can't be serialized");
+		break;
+	}
+}
+
+void BinaryWriter::_write_object_record(Reflected* object) {
+	_write_string(object->get_class_name().str());
+
+	// Only properties that can be restored are worth writing
+	std::vector<const ClassInfo::Property*> properties;
+	if (const ClassInfo* info = object->get_class_info()) {
+		info->property_table.for_each([&](const ClassInfo::Property& property) {
+			if (property.getter && property.setter)
+				properties.push_back(&property);
+		});
+	}
+
+	_write_varint(properties.size());
+	for (const ClassInfo::Property* property : properties) {
+		_write_string(property->name.str());
+		write_variant(property->getter(object));
+	}
+}
+
+// Reader
+
+BinaryReader::BinaryReader(std::span<const std::byte> data, bool zero_copy) : _data(data), _zero_copy(zero_copy) {
+	char file_magic[sizeof(magic)];
+	if (!_read_bytes(file_magic, sizeof(file_magic)) || std::memcmp(file_magic, magic, sizeof(magic)) != 0) {
+		_fail("Not a binary Variant stream");
+		return;
+	}
+	if (_read_pod<uint8_t>() != format_version) {
+		_fail("Unsupported binary format version");
+		return;
+	}
+	if (_read_pod<uint8_t>() != sizeof(real_t)) {
+		_fail("Stream was written with a different real_t precision");
+	}
+}
+
+std::vector<std::unique_ptr<Reflected>> BinaryReader::take_objects() {
+	return std::move(_owned_objects);
+}
+
+void BinaryReader::_fail(std::string_view message) {
+	if (_error.empty())
+		_error = message;
+	// Nothing after the first error can be trusted
+	_position = _data.size();
+}
+
+bool BinaryReader::_read_bytes(void* out, size_t size) {
+	if (has_error() || _data.size() - _position < size) {
+		_fail("Unexpected end of stream");
+		return false;
+	}
+	std::memcpy(out, _data.data() + _position, size);
+	_position += size;
+	return true;
+}
+
+uint64_t BinaryReader::_read_varint() {
+	uint64_t value = 0;
+	for (uint32_t shift = 0; shift < 64; shift += 7) {
+		uint8_t byte;
+		if (!_read_bytes(&byte, 1))
+			return 0;
+		value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			return value;
+	}
+	_fail("Varint is too long");
+	return 0;
+}
+
+template <class T>
+T BinaryReader::_read_pod() {
+	static_assert(std::is_trivially_copyable_v<T>);
+	T value {};
+	_read_bytes(&value, sizeof(T));
+	return value;
+}
+
+std::string_view BinaryReader::_read_string() {
+	const uint64_t size = _read_varint();
+	if (has_error() || _data.size() - _position < size) {
+		_fail("Unexpected end of stream");
+		return {};
+	}
+	std::string_view str(reinterpret_cast<const char*>(_data.data() + _position), size);
+	_position += size;
+	return str;
+}
+
+template <class T>
+CowVector<T> BinaryReader::_read_packed() {
+	const uint64_t count = _read_varint();
+	_position = std::min(_data.size(), (_position + alignof(T) - 1) / alignof(T) * alignof(T));
+	if (has_error() || (_data.size() - _position) / sizeof(T) < count) {
+		_fail("Unexpected end of stream");
+		return {};
+	}
+
+	const std::byte* block = _data.data() + _position;
+	_position += count * sizeof(T);
+	// The block is only aligned in memory if the buffer itself is, as a mapping always is
+	if (_zero_copy && reinterpret_cast<uintptr_t>(block) % alignof(T) == 0) {
+		return CowVector<T>::borrow(std::span(reinterpret_cast<const T*>(block), count));
+	}
+
+	CowVector<T> array;
+	array.resize(count);
+	if (count > 0)
+		std::memcpy(array.data(), block, count * sizeof(T));
+	return array;
+}
+
+Reflected* BinaryReader::read_object() {
+	Variant value = read_variant();
+	if (!value.is_type(VariantType::OBJECT)) {
+		_fail("Expected an object");
+		return nullptr;
+	}
+	return value.get_unchecked<Reflected*>();
+}
+
+Variant BinaryReader::read_variant() {
+	if (has_error())
+		return {};
+	if (++_depth > max_depth) {
+		_fail("Values are nested too deeply");
+		return {};
+	}
+	Variant value = _read_value();
+	--_depth;
+	return has_error() ? Variant() : value;
+}
+
+Variant BinaryReader::_read_value() {
+	const VariantType type = _read_pod<VariantType>();
+
+	switch (type) {
+	case VariantType::NIL:
+		return {};
+	case VariantType::BOOL:
+		return _read_pod<uint8_t>() != 0;
+	case VariantType::INT:
+		return static_cast<int>(zigzag_decode(_read_varint()));
+	case VariantType::FLOAT:
+		return _read_pod<real_t>();
+	case VariantType::VECTOR3:
+		return _read_pod<Vector3>();
+	case VariantType::VECTOR2:
+		return _read_pod<Vector2>();
+	case VariantType::VERTEX:
+		return _read_pod<Vertex>();
+	case VariantType::COLOR:
+		return _read_pod<Color>();
+	case VariantType::RID:
+		return RID { .id = static_cast<size_t>(_read_varint()) };
+	case VariantType::STRING:
+		return std::string(_read_string());
+	case VariantType::ARRAY: {
+		const uint64_t count = _read_varint();
+		// Every element takes at least its tag byte
+		if (count > _data.size() - _position) {
+			_fail("Unexpected end of stream");
+			return {};
+		}
+		VariantArray array;
+		array.reserve(count);
+		for (uint64_t i = 0; i < count && !has_error(); ++i) {
+			array.push_back(read_variant());
+		}
+		return array;
+	}
+	case VariantType::PATH: {
+		const std::string_view path = _read_string();
+		return Path(std::u8string(reinterpret_cast<const char8_t*>(path.data()), path.size()));
+	}
+	case VariantType::PACKED_BYTE_ARRAY:
+		return _read_packed<uint8_t>();
+	case VariantType::PACKED_INT32_ARRAY:
+		return _read_packed<int32_t>();
+	case VariantType::PACKED_FLOAT32_ARRAY:
+		return _read_packed<float>();
+	case VariantType::PACKED_VECTOR3_ARRAY:
+		return _read_packed<Vector3>();
+	case VariantType::PACKED_VERTEX_ARRAY:
+		return _read_packed<Vertex>();
+	case VariantType::OBJECT: {
+		const uint64_t ref = _read_varint();
+		if (ref == 0)
+			return static_cast<Reflected*>(nullptr);
+		if (ref - 1 < _objects.size())
+			return _objects[ref - 1];
+		if (ref - 1 == _objects.size())
+			return _read_object_record();
+		_fail("Object reference out of range");
+		return {};
+	}
+	default:
+		_fail("Unknown Variant type");
+		return {};
+	}
+}
+
+Reflected* BinaryReader::_read_object_record() {
+	const std::string_view class_name = _read_string();
+	if (has_error())
+		return nullptr;
+
+	// Registered before its properties are read so they can refer back to it
+	Reflected* object = ClassDB::create_object_unsafe(class_name);
+	_objects.push_back(object);
+	if (object)
+		_owned_objects.emplace_back(object);
+	const ClassInfo* info = object ? object->get_class_info() : nullptr;
+
+	const uint64_t count = _read_varint();
+	for (uint64_t i = 0; i < count && !has_error(); ++i) {
+		const StaticString name(_read_string());
+		Variant value = read_variant();
+		const ClassInfo::Property* property = info ? info->property_table.find(name) : nullptr;
+		if (property && property->setter && property->accepts(value)) {
+			property->setter(object, value);
+		}
+	}
+	return object;
+}
+
+} // namespace feather
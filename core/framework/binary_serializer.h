@@ -0,0 +1,98 @@
+#pragma once
+
+#include "packed_arrays.h"
+#include "path.h"
+#include "variant.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace feather {
+
+// Compact binary encoding of Variants and reflected objects.
+//
+// A stream starts with a header (magic, format version, width of real_t),
+// followed by values. A value is its VariantType tag and a payload: integers
+// and lengths are LEB128 varints (signed ones zigzagged), PODs are stored
+// little-endian as they are in memory, and packed arrays are a count followed
+// by the elements as one raw block, padded to start aligned within the stream.
+// An object is written once, as its class name and every property that has
+// both accessors (see ClassInfo::properties); later references point back at
+// that record, so shared and cyclic references survive a round trip.
+class BinaryWriter {
+public:
+	BinaryWriter();
+
+	void write_variant(const Variant& value);
+	void write_object(Reflected* object);
+
+	const std::vector<std::byte>& get_buffer() const { return _buffer; }
+	bool save(const Path& path) const;
+
+private:
+	std::vector<std::byte> _buffer;
+	// Index of each object already written in the stream's object table
+	std::unordered_map<const Reflected*, uint64_t> _object_ids;
+
+	void _write_bytes(const void* data, size_t size);
+	void _write_varint(uint64_t value);
+	template <class T>
+	void _write_pod(const T& value);
+	void _write_string(std::string_view str);
+	template <class T>
+	void _write_packed(const CowVector<T>& array);
+	void _write_object_record(Reflected* object);
+};
+
+// Reads a BinaryWriter stream. In zero-copy mode packed arrays borrow their
+// raw blocks (see CowVector::borrow) instead of copying them, so the data must
+// outlive every array read from it -- typically it's a MappedFile.
+//
+// Malformed input doesn't assert: the reader records an error and returns NIL
+// from then on. Properties or classes that no longer exist are skipped, as are
+// values a property can't take (e.g. an object of the wrong class).
+class BinaryReader {
+public:
+	explicit BinaryReader(std::span<const std::byte> data, bool zero_copy = false);
+
+	Variant read_variant();
+	// The object stays owned by the reader until take_objects()
+	Reflected* read_object();
+
+	// Every object created so far, in stream order
+	std::vector<std::unique_ptr<Reflected>> take_objects();
+
+	[[nodiscard]] bool at_end() const { return _position == _data.size(); }
+	[[nodiscard]] bool has_error() const { return !_error.empty(); }
+	[[nodiscard]] const std::string& get_error() const { return _error; }
+
+private:
+	std::span<const std::byte> _data;
+	size_t _position = 0;
+	bool _zero_copy;
+	uint32_t _depth = 0;
+	std::string _error;
+
+	// Indexed by object id; null for records whose class couldn't be created
+	std::vector<Reflected*> _objects;
+	std::vector<std::unique_ptr<Reflected>> _owned_objects;
+
+	void _fail(std::string_view message);
+	bool _read_bytes(void* out, size_t size);
+	uint64_t _read_varint();
+	template <class T>
+	T _read_pod();
+	std::string_view _read_string();
+	template <class T>
+	CowVector<T> _read_packed();
+	Variant _read_value();
+	Reflected* _read_object_record();
+};
+
+} // namespace feather
@@ -1,13 +1,11 @@
 #include "callable.h"
+#include "class_info.h"
 
 using namespace std::literals;
 
 namespace feather {
 
-Callable::Callable() : _internal_func { nullptr }, _param_amount(0) {
-}
-
-Variant Callable::call(std::span<Variant> params) {
+Variant Callable::call(std::span<Variant> params) const {
 	if (!is_valid()) {
 		std::println(std::cout, "Attempting to call an invalid Callable");
 		return {};
@@ -19,11 +17,31 @@ Variant Callable::call(std::span<Variant> params) {
 							_param_amount,
 							params.size()));
 	}
-	return _internal_func(params);
+	return _thunk(*this, params);
 }
 
 bool Callable::is_valid() const {
-	return _internal_func != nullptr;
+	return _thunk != nullptr;
+}
+
+void Callable::_argument_mismatch(size_t index, VariantType expected, VariantType actual) {
+	fassert(false,
+			std::format("Callable argument {} has the wrong type. Expected {} and got {}",
+						index,
+						std::to_underlying(expected),
+						std::to_underlying(actual)));
+	std::unreachable();
+}
+
+void Callable::_argument_mismatch(size_t index, const ClassInfo* expected, const Reflected* actual) {
+	const ClassInfo* actual_info = actual ? actual->get_class_info() : nullptr;
+	fassert(false,
+			std::format("Callable argument {} has the wrong class. Expected {} and got {}",
+						index,
+						expected ? expected->name.str() : "an unregistered class"sv,
+						actual ? (actual_info ? actual_info->name.str() : "an unregistered class"sv)
+							   : "null"sv));
+	std::unreachable();
 }
 
 } //namespace feather
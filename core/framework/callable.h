@@ -3,56 +3,305 @@
 #include "assert.h"
 #include "variant.h"
 
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <functional>
+#include <new>
 #include <span>
 #include <tuple>
 #include <type_traits>
+#include <utility>
 
 namespace feather {
 
+// Type-erased function taking and returning Variants.
+//
+// The target is kept in an inline buffer (a heap copy only for captures that
+// don't fit, made once at construction) and invoked through a thunk generated
+// per signature. The thunk checks each argument's type tag and reads the
+// payload in place: trivially stored values by value, boxed ones (strings,
+// arrays...) by reference into the argument Variant. A call never allocates
+// beyond what the target itself does.
 class Callable {
-	std::function<Variant(std::span<Variant>)> _internal_func;
-	uint8_t _param_amount;
+	// Fits a member function pointer or a small lambda
+	static constexpr size_t _storage_size = 3 * sizeof(void*);
+
+	enum class _Op : uint8_t {
+		Copy,
+		Move,
+		Destroy,
+	};
+
+	using Thunk = Variant (*)(const Callable& self, std::span<Variant> params);
+	// Copies/moves/destroys non-trivial targets; null when a memcpy is enough
+	using Manager = void (*)(_Op op, std::byte* dst, std::byte* src);
+
+	alignas(void*) std::byte _storage[_storage_size] {};
+	Thunk _thunk = nullptr;
+	Manager _manager = nullptr;
+	uint8_t _param_amount = 0;
+
+	template <class F>
+	static constexpr bool _stores_inline = sizeof(F) <= _storage_size && alignof(F) <= alignof(void*) &&
+			std::is_nothrow_move_constructible_v<F>;
+
+	// A target known at compile time (see from_method<>/from_function<>) has no
+	// state, so nothing is stored for it
+	template <class F>
+	static constexpr bool _is_stateless = std::is_empty_v<F> && std::is_trivially_default_constructible_v<F>;
+
+	template <class F>
+	F& _target() const {
+		std::byte* storage = const_cast<std::byte*>(_storage);
+		if constexpr (_is_stateless<F>) {
+			static F stateless;
+			return stateless;
+		}
+		else if constexpr (_stores_inline<F>)
+			return *std::launder(reinterpret_cast<F*>(storage));
+		else
+			return **std::launder(reinterpret_cast<F**>(storage));
+	}
+
+	template <class F>
+	static void _manage(_Op op, std::byte* dst, std::byte* src) {
+		if constexpr (_stores_inline<F>) {
+			switch (op) {
+			case _Op::Copy:
+				new (dst) F(*std::launder(reinterpret_cast<const F*>(src)));
+				break;
+			case _Op::Move:
+				new (dst) F(std::move(*std::launder(reinterpret_cast<F*>(src))));
+				std::launder(reinterpret_cast<F*>(src))->~F();
+				break;
+			case _Op::Destroy:
+				std::launder(reinterpret_cast<F*>(dst))->~F();
+				break;
+			}
+		}
+		else {
+			switch (op) {
+			case _Op::Copy:
+				new (dst) F*(new F(**std::launder(reinterpret_cast<F* const*>(src))));
+				break;
+			case _Op::Move:
+				std::memcpy(dst, src, sizeof(F*));
+				break;
+			case _Op::Destroy:
+				delete *std::launder(reinterpret_cast<F**>(dst));
+				break;
+			}
+		}
+	}
+
+	// How a converted argument is held until the call: boxed payloads by const
+	// reference into the argument Variant, objects by reference, the rest by value.
+	// A non-const reference parameter gets its own copy to bind to.
+	template <class A>
+	using _arg_holder_t = std::conditional_t<
+			std::is_lvalue_reference_v<A> && !std::is_const_v<std::remove_reference_t<A>> &&
+					!is_reflected_class_type<std::remove_cvref_t<A>>,
+			std::remove_cvref_t<A>,
+			decltype(std::declval<const Variant&>().get_unchecked<std::remove_cvref_t<A>>())>;
+
+	[[noreturn]] static void _argument_mismatch(size_t index, VariantType expected, VariantType actual);
+	// params[0] holds an object that isn't of the method's class (or is null)
+	[[noreturn]] static void _argument_mismatch(size_t index, const ClassInfo* expected, const Reflected* actual);
+
+	template <class F, class TRet, class... TArgs, size_t... I>
+	static Variant _invoke(const Callable& self, [[maybe_unused]] std::span<Variant> params, std::index_sequence<I...>) {
+		(
+				[&] {
+					constexpr VariantType expected = get_variant_type<std::remove_cvref_t<TArgs>>();
+					if (params[I].get_type() != expected) [[unlikely]]
+						_argument_mismatch(I, expected, params[I].get_type());
+				}(),
+				...);
+
+		[[maybe_unused]] std::tuple<_arg_holder_t<TArgs>...> args { params[I].template get_unchecked<std::remove_cvref_t<TArgs>>()... };
+		F& target = self._target<F>();
+		if constexpr (std::is_void_v<TRet>) {
+			std::invoke(target, std::get<I>(args)...);
+			return Variant();
+		}
+		else {
+			return Variant(std::invoke(target, std::get<I>(args)...));
+		}
+	}
+
+	template <class F, class TRet, class... TArgs>
+	static Variant _thunk_for(const Callable& self, std::span<Variant> params) {
+		return _invoke<F, TRet, TArgs...>(self, params, std::index_sequence_for<TArgs...> {});
+	}
+
+	constexpr Callable(Thunk thunk, uint8_t param_amount) : _thunk(thunk), _param_amount(param_amount) {}
+
+	template <class TRet, class... TArgs, class F>
+	void _emplace(F&& f) {
+		using Target = std::decay_t<F>;
+		if constexpr (_stores_inline<Target>)
+			new (_storage) Target(std::forward<F>(f));
+		else
+			new (_storage) Target*(new Target(std::forward<F>(f)));
+
+		_thunk = &_thunk_for<Target, TRet, TArgs...>;
+		if constexpr (!_stores_inline<Target> || !std::is_trivially_copyable_v<Target>)
+			_manager = &_manage<Target>;
+		_param_amount = sizeof...(TArgs);
+	}
+
+	// A method can be called with any object in params[0], so check it's a T
+	// (two compares, see ClassInfo::is_a) before calling through it. TObject is
+	// only a template parameter so Reflected and ClassInfo can be incomplete here.
+	template <class T, class TObject>
+	static T* _object_as(TObject* object) {
+		const auto* info = object ? object->get_class_info() : nullptr;
+		const auto* base = T::get_class_info_static();
+		if (!info || !base || !info->is_a(*base)) [[unlikely]]
+			_argument_mismatch(0, base, object);
+		return static_cast<T*>(object);
+	}
+
+	// Member function called on params[0]
+	template <class T, class TMethod>
+	struct _MemberInvoker {
+		TMethod method;
+
+		template <class... TArgs>
+		decltype(auto) operator()(Reflected* object, TArgs&&... args) const {
+			return (_object_as<T>(object)->*method)(std::forward<TArgs>(args)...);
+		}
+	};
+
+	template <auto Method, class T>
+	struct _FixedMemberInvoker {
+		template <class... TArgs>
+		decltype(auto) operator()(Reflected* object, TArgs&&... args) const {
+			return (_object_as<T>(object)->*Method)(std::forward<TArgs>(args)...);
+		}
+	};
+
+	template <auto Func>
+	struct _FixedInvoker {
+		template <class... TArgs>
+		decltype(auto) operator()(TArgs&&... args) const {
+			return Func(std::forward<TArgs>(args)...);
+		}
+	};
+
+	template <auto Method, class T, class TRet, class... TArgs>
+		requires(VariantCompatible<std::decay_t<TRet>>) && (VariantCompatible<std::decay_t<TArgs>> && ...)
+	static constexpr Callable _fixed_method(TRet (T::*)(TArgs...)) {
+		return Callable(&_thunk_for<_FixedMemberInvoker<Method, T>, TRet, Reflected*, TArgs...>, sizeof...(TArgs) + 1);
+	}
+
+	template <auto Method, class T, class TRet, class... TArgs>
+		requires(VariantCompatible<std::decay_t<TRet>>) && (VariantCompatible<std::decay_t<TArgs>> && ...)
+	static constexpr Callable _fixed_method(TRet (T::*)(TArgs...) const) {
+		return Callable(&_thunk_for<_FixedMemberInvoker<Method, T>, TRet, Reflected*, TArgs...>, sizeof...(TArgs) + 1);
+	}
+
+	template <auto Func, class TRet, class... TArgs>
+		requires(VariantCompatible<std::decay_t<TRet>>) && (VariantCompatible<std::decay_t<TArgs>> && ...)
+	static constexpr Callable _fixed_function(TRet (*)(TArgs...)) {
+		return Callable(&_thunk_for<_FixedInvoker<Func>, TRet, TArgs...>, sizeof...(TArgs));
+	}
 
 public:
-	Callable();
+	Callable() = default;
+
 	template <class TRet, class... TArgs>
 		requires(VariantCompatible<std::decay_t<TRet>>) && (VariantCompatible<std::decay_t<TArgs>> && ...)
-	Callable(std::function<TRet(TArgs...)> func)
-			: _internal_func { [func](std::span<Variant> params) {
-				size_t i = 0;
-				std::tuple<std::decay_t<TArgs>...> converted_args = {
-					params[i++].as<std::decay_t<TArgs>>().value()...
-				};
-				if constexpr (std::is_void_v<TRet>) {
-					std::apply(func, converted_args);
-					return Variant();
-				}
-				else {
-					TRet result = std::apply(func, converted_args);
-					return Variant(std::move(result));
-				}
-			} }
-			, _param_amount { sizeof...(TArgs) } {}
+	Callable(TRet (*func_ptr)(TArgs...)) {
+		_emplace<TRet, TArgs...>(func_ptr);
+	}
 
 	template <class TRet, class... TArgs>
 		requires(VariantCompatible<std::decay_t<TRet>>) && (VariantCompatible<std::decay_t<TArgs>> && ...)
-	Callable(TRet (*func_ptr)(TArgs...)) : Callable(std::function<TRet(TArgs...)>(func_ptr)) {}
+	Callable(std::function<TRet(TArgs...)> func) {
+		_emplace<TRet, TArgs...>(std::move(func));
+	}
+
+	// Bound member function; the object is passed as params[0]
+	template <class T, class TRet, class... TArgs>
+		requires(VariantCompatible<std::decay_t<TRet>>) && (VariantCompatible<std::decay_t<TArgs>> && ...)
+	static Callable from_method(TRet (T::*method)(TArgs...)) {
+		Callable callable;
+		callable._emplace<TRet, Reflected*, TArgs...>(_MemberInvoker<T, decltype(method)> { method });
+		return callable;
+	}
+
+	template <class T, class TRet, class... TArgs>
+		requires(VariantCompatible<std::decay_t<TRet>>) && (VariantCompatible<std::decay_t<TArgs>> && ...)
+	static Callable from_method(TRet (T::*method)(TArgs...) const) {
+		Callable callable;
+		callable._emplace<TRet, Reflected*, TArgs...>(_MemberInvoker<T, decltype(method)> { method });
+		return callable;
+	}
 
-	Callable(Callable&&) = default;
-	Callable(const Callable&) = default;
-	Callable& operator=(const Callable&) = default;
-	Callable& operator=(Callable&&) = default;
+	// Compile-time bound forms: the target is a template argument, so the
+	// Callable stores nothing and can live in a constexpr table (see ClassDB)
+	template <auto Method>
+		requires std::is_member_function_pointer_v<decltype(Method)>
+	static constexpr Callable from_method() {
+		return _fixed_method<Method>(Method);
+	}
+
+	template <auto Func>
+		requires std::is_pointer_v<decltype(Func)> && std::is_function_v<std::remove_pointer_t<decltype(Func)>>
+	static constexpr Callable from_function() {
+		return _fixed_function<Func>(Func);
+	}
+
+	Callable(const Callable& other) : _thunk(other._thunk), _manager(other._manager), _param_amount(other._param_amount) {
+		if (_manager)
+			_manager(_Op::Copy, _storage, const_cast<std::byte*>(other._storage));
+		else
+			std::memcpy(_storage, other._storage, _storage_size);
+	}
+
+	Callable(Callable&& other) noexcept
+			: _thunk(std::exchange(other._thunk, nullptr))
+			, _manager(std::exchange(other._manager, nullptr))
+			, _param_amount(std::exchange(other._param_amount, 0)) {
+		if (_manager)
+			_manager(_Op::Move, _storage, other._storage);
+		else
+			std::memcpy(_storage, other._storage, _storage_size);
+	}
+
+	Callable& operator=(const Callable& other) {
+		if (this != &other) {
+			Callable copy(other);
+			*this = std::move(copy);
+		}
+		return *this;
+	}
+
+	Callable& operator=(Callable&& other) noexcept {
+		if (this != &other) {
+			this->~Callable();
+			new (this) Callable(std::move(other));
+		}
+		return *this;
+	}
+
+	constexpr ~Callable() {
+		if (_manager)
+			_manager(_Op::Destroy, _storage, nullptr);
+	}
 
-	Variant call(std::span<Variant> params);
+	Variant call(std::span<Variant> params) const;
 
-	Variant call(auto&&... args) {
+	// Arguments are forwarded into the parameter array, so Variants passed as
+	// rvalues are moved rather than copied
+	Variant call(auto&&... args) const {
 		if constexpr (sizeof...(args) == 0) {
 			return call(std::span<Variant>());
 		}
 		else {
-			Variant params[] = { args... };
+			Variant params[] = { Variant(std::forward<decltype(args)>(args))... };
 			return call(std::span<Variant>(params, sizeof...(args)));
 		}
 	}
@@ -60,4 +309,4 @@ class Callable {
 	bool is_valid() const;
 };
 
-} // namespace feather
\ No newline at end of file
+} // namespace feather
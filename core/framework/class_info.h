@@ -1,11 +1,16 @@
 #pragma once
 
 #include "callable.h"
+#include "object_pool.h"
 #include "static_string.hpp"
 #include "variant.h"
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
 #include <cstdint>
-#include <functional>
+#include <memory>
+#include <span>
 #include <vector>
 
 namespace feather {
@@ -18,11 +23,110 @@ enum class AccessLevel : uint8_t {
 	Private,
 };
 
+// Open-addressing table (linear probing, power-of-two capacity, at most half full)
+// from a member's StaticString hash to the member. Names are compared on a hash
+// match, so two members whose names collide on crc32 still resolve correctly.
+template <class TMember>
+class MemberTable {
+	struct Slot {
+		uint32_t hash = 0;
+		const TMember* member = nullptr;
+	};
+
+	std::vector<Slot> _slots;
+	size_t _size = 0;
+
+public:
+	// Keeps the first member inserted under a name, so inserting the most derived
+	// class first lets overrides shadow inherited members.
+	void insert(const TMember& member) {
+		if ((_size + 1) * 2 > _slots.size()) {
+			std::vector<Slot> old = std::move(_slots);
+			_slots.assign(std::bit_ceil(std::max<size_t>(8, (_size + 1) * 2)), {});
+			_size = 0;
+			for (const Slot& slot : old) {
+				if (slot.member)
+					insert(*slot.member);
+			}
+		}
+
+		const size_t mask = _slots.size() - 1;
+		const uint32_t hash = static_cast<uint32_t>(member.name.hash());
+		for (size_t i = hash & mask;; i = (i + 1) & mask) {
+			Slot& slot = _slots[i];
+			if (!slot.member) {
+				slot = { hash, &member };
+				++_size;
+				return;
+			}
+			if (slot.hash == hash && slot.member->name.str() == member.name.str())
+				return;
+		}
+	}
+
+	const TMember* find(const StaticString& name) const {
+		if (_slots.empty())
+			return nullptr;
+
+		const size_t mask = _slots.size() - 1;
+		const uint32_t hash = static_cast<uint32_t>(name.hash());
+		for (size_t i = hash & mask;; i = (i + 1) & mask) {
+			const Slot& slot = _slots[i];
+			if (!slot.member)
+				return nullptr;
+			if (slot.hash == hash && slot.member->name.str() == name.str())
+				return slot.member;
+		}
+	}
+
+	// Visits every member once, in table order
+	template <class F>
+	void for_each(F&& f) const {
+		for (const Slot& slot : _slots) {
+			if (slot.member)
+				f(*slot.member);
+		}
+	}
+
+	void clear() {
+		_slots.clear();
+		_size = 0;
+	}
+
+	size_t size() const { return _size; }
+};
+
 struct ClassInfo {
 	StaticString name = ""_ss;
 	StaticString parent = ""_ss;
 	std::vector<const ClassInfo*> children;
 
+	// Preorder index in the class hierarchy and one past the last index of its
+	// subtree. A class is within its ancestors' ranges, so is-a is two compares.
+	// ClassDB renumbers the hierarchy when a class registers outside a
+	// ClassDB::RegistrationBatch, e.g. from an extension, while other threads
+	// may be checking is_a: the ids are atomics under a sequence lock, and a
+	// check that overlaps a renumbering reads again.
+	std::atomic<uint32_t> class_id { 0 };
+	std::atomic<uint32_t> subtree_end { 0 };
+	// Odd while ClassDB renumbers. Out of line so extensions read core's
+	// counter rather than a copy of their own.
+	static const std::atomic<uint32_t>& get_id_sequence();
+
+	// True for base itself and for every class derived from it
+	bool is_a(const ClassInfo& base) const {
+		const std::atomic<uint32_t>& id_sequence = get_id_sequence();
+		while (true) {
+			const uint32_t sequence = id_sequence.load(std::memory_order_acquire);
+			const uint32_t id = class_id.load(std::memory_order_relaxed);
+			const uint32_t first = base.class_id.load(std::memory_order_relaxed);
+			const uint32_t end = base.subtree_end.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (!(sequence & 1) && id_sequence.load(std::memory_order_relaxed) == sequence)
+				return first <= id && id < end;
+		}
+	}
+
 	// Abstract/singleton classes have a null object_create_func.
 	bool is_abstract = false;
 	bool is_singleton = false;
@@ -30,6 +134,9 @@ struct ClassInfo {
 	// Property::getter/setter's void* is a raw T*, not a Reflected*.
 	bool is_value_type = false;
 
+	// Property and Method are literal types: the codegen emits them as constexpr
+	// arrays (see ClassDB::describe_property/describe_method) that ClassInfo
+	// references in place.
 	struct Property {
 		StaticString name;
 		// variant type to convert to
@@ -40,22 +147,60 @@ struct ClassInfo {
 		AccessLevel getter_access = AccessLevel::Public;
 		AccessLevel setter_access = AccessLevel::Public;
 
-		// Function pointers for get/set
-		std::function<Variant(void*)> getter; // Takes object pointer, returns Variant
-		std::function<void(void*, Variant)> setter; // Takes object pointer and value
+		// Thunks generated per accessor; null when the accessor doesn't exist
+		Variant (*getter)(void* object) = nullptr;
+		void (*setter)(void* object, const Variant& value) = nullptr;
+
+		// OBJECT properties: the class a value must be or derive from (resolved
+		// lazily, as classes register after their descriptors are built), and
+		// whether null is a valid value
+		const ClassInfo* (*object_class)() = nullptr;
+		bool object_nullable = false;
+
+		// Whether the setter can safely be handed value: the setter only checks
+		// the type tag, not the class of an object
+		bool accepts(const Variant& value) const {
+			if (value.get_type() != type)
+				return false;
+			if (type != VariantType::OBJECT)
+				return true;
+			const Reflected* object = value.get_unchecked<Reflected*>();
+			if (!object)
+				return object_nullable;
+			const ClassInfo* base = object_class ? object_class() : nullptr;
+			const ClassInfo* info = object->get_class_info();
+			return base && info && info->is_a(*base);
+		}
 	};
-	std::vector<Property> properties;
+	std::span<const Property> properties;
 
 	struct Method {
 		StaticString name;
 		// Possibly need to store param names later
 		AccessLevel access = AccessLevel::Public;
 		Callable callable;
+		// No object in params[0]
+		bool is_static = false;
 	};
 
-	std::vector<Method> methods;
+	std::span<const Method> methods;
+	// Bound at runtime through ClassDB::bind_method/bind_static_method (e.g. by
+	// codegen modifiers) rather than through the descriptor arrays
+	std::vector<Method> bound_methods;
+
+	// Own and inherited members flattened into one lookup each, rebuilt by ClassDB
+	// whenever this class or one of its ancestors finishes registering.
+	MemberTable<Property> property_table;
+	MemberTable<Method> method_table;
+
+	Reflected* (*object_create_func)() = nullptr;
 
-	std::function<Variant()> object_create_func;
+	// Captured at registration for creatable classes; the pool backs
+	// ClassDB::create_pooled_object/create_objects
+	size_t object_size = 0;
+	size_t object_alignment = 0;
+	Reflected* (*object_construct_func)(void* memory) = nullptr;
+	std::unique_ptr<ObjectPool> object_pool;
 };
 
 } //namespace feather
@@ -1,92 +1,210 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <cstdlib>
+#include <cstring>
 #include <initializer_list>
-#include <memory>
+#include <iterator>
+#include <memory_resource>
+#include <new>
 #include <span>
 #include <stdexcept>
-
-#ifdef _MSC_VER
-#define aligned_alloc(align, size) _aligned_malloc(size, align)
-#define aligned_free _aligned_free
-#elifdef __linux__
-#include <malloc.h>
-#define aligned_free free
-#else
-#define aligned_free free
-#endif
+#include <type_traits>
+#include <utility>
 
 namespace feather {
 
 template <class T>
 class CowVector {
 private:
-	struct buffer {
-		T* data;
+	// Header and elements share one allocation; the elements start at
+	// _data_offset. ref_count is intrusive, so sharing a buffer costs no control
+	// block and checking uniqueness is a single atomic load. It is a plain
+	// integer accessed through std::atomic_ref to keep the header trivially
+	// copyable, which is what lets _reallocate() hand the block to realloc.
+	//
+	// A buffer remembers the memory resource it came from (null = malloc), so it
+	// is always returned to the right place whichever vector drops it last.
+	//
+	// A borrowed buffer (see borrow()) is a bare header whose elements live in
+	// memory the vector doesn't own; it never counts as unique, so the first
+	// write detaches into an owned copy.
+	struct header {
+		alignas(std::atomic_ref<size_t>::required_alignment) size_t ref_count;
 		size_t size;
 		size_t capacity;
-		mutable size_t ref_count;
-
-		buffer(size_t cap = 0)
-				: data(cap > 0 ? static_cast<T*>(aligned_alloc(alignof(T), sizeof(T) * cap)) : nullptr)
-				, size(0)
-				, capacity(cap)
-				, ref_count(1) {}
-
-		~buffer() {
-			if (data) {
-				// Destroy all constructed elements
-				for (size_t i = 0; i < size; ++i) {
-					data[i].~T();
-				}
-				aligned_free(data);
+		std::pmr::memory_resource* resource;
+		T* elements;
+
+		T* data() noexcept { return elements; }
+		T* inline_data() noexcept { return reinterpret_cast<T*>(reinterpret_cast<std::byte*>(this) + _data_offset); }
+		bool is_borrowed() noexcept { return elements != inline_data(); }
+		std::atomic_ref<size_t> refs() noexcept { return std::atomic_ref<size_t>(ref_count); }
+	};
+
+	static constexpr size_t _alignment = std::max(alignof(header), alignof(T));
+	static constexpr size_t _data_offset = (sizeof(header) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+	// malloc already guarantees max_align_t alignment; only over-aligned T needs
+	// aligned operator new, which has no realloc counterpart.
+	static constexpr bool _use_malloc = _alignment <= alignof(std::max_align_t);
+	// Bitwise relocation is only valid when moving T is a plain byte copy
+	static constexpr bool _is_trivial = std::is_trivially_copyable_v<T>;
+	static constexpr bool _can_reallocate = _use_malloc && _is_trivial;
+
+	// Null until the first allocation, so empty vectors never touch the heap
+	header* buf_ = nullptr;
+	// Where this vector's own allocations go; null means the general heap via
+	// malloc, the only mode that can realloc in place.
+	std::pmr::memory_resource* resource_ = nullptr;
+
+	static constexpr size_t _bytes_for(size_t cap) { return _data_offset + sizeof(T) * cap; }
+
+	static header* _allocate(size_t cap, std::pmr::memory_resource* resource) {
+		void* memory;
+		if (resource) {
+			memory = resource->allocate(_bytes_for(cap), _alignment);
+		}
+		else if constexpr (_use_malloc) {
+			memory = std::malloc(_bytes_for(cap));
+			if (!memory)
+				throw std::bad_alloc();
+		}
+		else {
+			memory = ::operator new(_bytes_for(cap), std::align_val_t { _alignment });
+		}
+		header* buf = new (memory) header { .ref_count = 1, .size = 0, .capacity = cap, .resource = resource };
+		buf->elements = buf->inline_data();
+		return buf;
+	}
+
+	static void _deallocate(header* buf) noexcept {
+		if (buf->resource)
+			buf->resource->deallocate(buf, _bytes_for(buf->is_borrowed() ? 0 : buf->capacity), _alignment);
+		else if constexpr (_use_malloc)
+			std::free(buf);
+		else
+			::operator delete(buf, std::align_val_t { _alignment });
+	}
+
+	// Resizes a uniquely owned buffer in place when the allocator can, letting
+	// realloc extend or move the block without going through a second buffer.
+	static header* _reallocate(header* buf, size_t cap)
+		requires _can_reallocate
+	{
+		void* memory = std::realloc(buf, _bytes_for(cap));
+		if (!memory)
+			throw std::bad_alloc();
+		header* new_buf = static_cast<header*>(memory);
+		new_buf->capacity = cap;
+		new_buf->elements = new_buf->inline_data();
+		return new_buf;
+	}
+
+	static void _destroy(T* first, size_t count) noexcept {
+		if constexpr (!std::is_trivially_destructible_v<T>) {
+			for (size_t i = 0; i < count; ++i) {
+				first[i].~T();
 			}
 		}
+	}
 
-		// Non-copyable, non-movable
-		buffer(const buffer&) = delete;
-		buffer& operator=(const buffer&) = delete;
-		buffer(buffer&&) = delete;
-		buffer& operator=(buffer&&) = delete;
-	};
+	static void _copy_construct(T* dst, const T* src, size_t count) {
+		if constexpr (_is_trivial) {
+			if (count > 0)
+				std::memcpy(dst, src, sizeof(T) * count);
+		}
+		else {
+			for (size_t i = 0; i < count; ++i) {
+				new (dst + i) T(src[i]);
+			}
+		}
+	}
+
+	// Move-constructs count elements into dst and destroys the sources
+	static void _relocate(T* dst, T* src, size_t count) {
+		if constexpr (_is_trivial) {
+			if (count > 0)
+				std::memcpy(dst, src, sizeof(T) * count);
+		}
+		else {
+			for (size_t i = 0; i < count; ++i) {
+				new (dst + i) T(std::move(src[i]));
+				src[i].~T();
+			}
+		}
+	}
+
+	static void _retain(header* buf) noexcept {
+		if (buf)
+			buf->refs().fetch_add(1, std::memory_order_relaxed);
+	}
+
+	static void _release(header* buf) noexcept {
+		if (buf && buf->refs().fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			_destroy(buf->data(), buf->size);
+			_deallocate(buf);
+		}
+	}
 
-	mutable std::shared_ptr<buffer> buf_;
+	bool _is_unique() const noexcept {
+		return buf_->refs().load(std::memory_order_acquire) == 1 && !buf_->is_borrowed();
+	}
 
-	// Ensure we have a unique copy of the buffer
+	// Ensure we have a unique copy of the buffer (a null buffer is trivially unique)
 	void ensure_unique() {
-		if (!buf_ || buf_.use_count() > 1) {
-			auto new_buf = std::make_shared<buffer>(buf_ ? std::max(buf_->capacity, buf_->size) : 0);
-			if (buf_ && buf_->size > 0) {
-				new_buf->size = buf_->size;
-				// Copy construct elements
-				for (size_t i = 0; i < buf_->size; ++i) {
-					new (new_buf->data + i) T(buf_->data[i]);
-				}
-			}
+		if (buf_ && !_is_unique()) {
+			header* new_buf = _allocate(std::max(buf_->capacity, buf_->size), resource_);
+			_copy_construct(new_buf->data(), buf_->data(), buf_->size);
+			new_buf->size = buf_->size;
+			_release(buf_);
 			buf_ = new_buf;
 		}
 	}
 
-	void ensure_capacity(size_t min_cap) {
-		ensure_unique();
-		if (buf_->capacity < min_cap) {
-			size_t new_cap = std::max(min_cap, buf_->capacity * 2);
-			if (new_cap == 0)
-				new_cap = 1;
-
-			T* new_data = static_cast<T*>(aligned_alloc(alignof(T), sizeof(T) * new_cap));
+	// Unique buffer holding exactly new_cap slots, keeping the current elements
+	void _rebuffer(size_t new_cap) {
+		if (!buf_) {
+			buf_ = _allocate(new_cap, resource_);
+			return;
+		}
 
-			// Move construct elements to new buffer
-			for (size_t i = 0; i < buf_->size; ++i) {
-				new (new_data + i) T(std::move(buf_->data[i]));
-				buf_->data[i].~T();
+		const bool unique = _is_unique();
+		if constexpr (_can_reallocate) {
+			if (unique && !buf_->resource && !resource_) {
+				buf_ = _reallocate(buf_, new_cap);
+				return;
 			}
+		}
 
-			aligned_free(buf_->data);
-			buf_->data = new_data;
-			buf_->capacity = new_cap;
+		header* new_buf = _allocate(new_cap, resource_);
+		if (unique) {
+			_relocate(new_buf->data(), buf_->data(), buf_->size);
+			new_buf->size = std::exchange(buf_->size, 0);
+		}
+		else {
+			_copy_construct(new_buf->data(), buf_->data(), buf_->size);
+			new_buf->size = buf_->size;
 		}
+		_release(buf_);
+		buf_ = new_buf;
+	}
+
+	// Unique buffer with room for at least min_cap elements; copying a shared
+	// buffer and growing happen in a single allocation.
+	void ensure_capacity(size_t min_cap) {
+		const size_t cap = capacity();
+		if (buf_ && _is_unique() && cap >= min_cap) {
+			return;
+		}
+
+		size_t new_cap = cap >= min_cap ? cap : std::max(min_cap, cap * 2);
+		if (new_cap == 0)
+			new_cap = 1;
+
+		_rebuffer(new_cap);
 	}
 
 public:
@@ -207,50 +325,86 @@ class CowVector {
 	};
 
 	// Constructors
-	CowVector() : buf_(std::make_shared<buffer>()) {}
+	CowVector() = default;
 
-	explicit CowVector(size_type count) : buf_(std::make_shared<buffer>(count)) {
-		buf_->size = count;
+	explicit CowVector(std::pmr::memory_resource* resource) : resource_(resource) {}
+
+	explicit CowVector(size_type count, std::pmr::memory_resource* resource = nullptr) : resource_(resource) {
+		if (count == 0)
+			return;
+		buf_ = _allocate(count, resource_);
 		for (size_t i = 0; i < count; ++i) {
-			new (buf_->data + i) T();
+			new (buf_->data() + i) T();
 		}
+		buf_->size = count;
 	}
 
-	CowVector(size_type count, const T& value) : buf_(std::make_shared<buffer>(count)) {
-		buf_->size = count;
+	CowVector(size_type count, const T& value, std::pmr::memory_resource* resource = nullptr) : resource_(resource) {
+		if (count == 0)
+			return;
+		buf_ = _allocate(count, resource_);
 		for (size_t i = 0; i < count; ++i) {
-			new (buf_->data + i) T(value);
+			new (buf_->data() + i) T(value);
 		}
+		buf_->size = count;
 	}
 
-	CowVector(std::initializer_list<T> init) : buf_(std::make_shared<buffer>(init.size())) {
-		buf_->size = init.size();
-		size_t i = 0;
-		for (const auto& item : init) {
-			new (buf_->data + i++) T(item);
-		}
-	}
+	CowVector(std::initializer_list<T> init, std::pmr::memory_resource* resource = nullptr)
+			: CowVector(init.begin(), init.end(), resource) {}
 
 	template <typename InputIt>
-	CowVector(InputIt first, InputIt last) {
+	CowVector(InputIt first, InputIt last, std::pmr::memory_resource* resource = nullptr) : resource_(resource) {
 		size_t count = std::distance(first, last);
-		buf_ = std::make_shared<buffer>(count);
-		buf_->size = count;
-		size_t i = 0;
-		for (auto it = first; it != last; ++it) {
-			new (buf_->data + i++) T(*it);
+		if (count == 0)
+			return;
+		buf_ = _allocate(count, resource_);
+		if constexpr (_is_trivial && std::contiguous_iterator<InputIt> &&
+					  std::is_same_v<std::remove_cv_t<std::iter_value_t<InputIt>>, T>) {
+			std::memcpy(buf_->data(), std::to_address(first), sizeof(T) * count);
+		}
+		else {
+			T* dst = buf_->data();
+			for (auto it = first; it != last; ++it) {
+				new (dst++) T(*it);
+			}
 		}
+		buf_->size = count;
 	}
 
-	// Copy constructor - COW magic happens here!
-	CowVector(const CowVector& other) : buf_(other.buf_) {}
+	// Shares memory the vector doesn't own, e.g. a memory-mapped file, without
+	// copying it. Reads alias data; the first write copies it into an owned
+	// buffer. data must stay valid until every vector sharing it has detached or
+	// been destroyed.
+	static CowVector borrow(std::span<const T> data, std::pmr::memory_resource* resource = nullptr)
+		requires _is_trivial
+	{
+		CowVector vector(resource);
+		if (data.empty())
+			return vector;
+		vector.buf_ = _allocate(0, resource);
+		vector.buf_->elements = const_cast<T*>(data.data());
+		vector.buf_->size = data.size();
+		vector.buf_->capacity = data.size();
+		return vector;
+	}
+
+	// Copy constructor - COW magic happens here! The copy keeps allocating from
+	// the same resource, so detaching later stays within e.g. the same arena.
+	CowVector(const CowVector& other) : buf_(other.buf_), resource_(other.resource_) { _retain(buf_); }
 
 	// Move constructor
-	CowVector(CowVector&& other) noexcept : buf_(std::move(other.buf_)) {}
+	CowVector(CowVector&& other) noexcept
+			: buf_(std::exchange(other.buf_, nullptr))
+			, resource_(other.resource_) {}
+
+	~CowVector() { _release(buf_); }
 
-	// Assignment operators
+	// Assignment operators share (or take) the buffer but keep this vector's own
+	// resource for its future allocations, like std::pmr containers.
 	CowVector& operator=(const CowVector& other) {
-		if (this != &other) {
+		if (buf_ != other.buf_) {
+			_retain(other.buf_);
+			_release(buf_);
 			buf_ = other.buf_;
 		}
 		return *this;
@@ -258,7 +412,8 @@ class CowVector {
 
 	CowVector& operator=(CowVector&& other) noexcept {
 		if (this != &other) {
-			buf_ = std::move(other.buf_);
+			_release(buf_);
+			buf_ = std::exchange(other.buf_, nullptr);
 		}
 		return *this;
 	}
@@ -278,62 +433,72 @@ class CowVector {
 			throw std::out_of_range("cow_vector::at");
 		}
 		ensure_unique();
-		return buf_->data[pos];
+		return buf_->data()[pos];
 	}
 
 	const_reference at(size_type pos) const {
 		if (pos >= size()) {
 			throw std::out_of_range("cow_vector::at");
 		}
-		return buf_->data[pos];
+		return buf_->data()[pos];
 	}
 
 	reference operator[](size_type pos) {
 		ensure_unique();
-		return buf_->data[pos];
+		return buf_->data()[pos];
 	}
 
-	const_reference operator[](size_type pos) const { return buf_->data[pos]; }
+	const_reference operator[](size_type pos) const { return buf_->data()[pos]; }
 
 	reference front() {
 		ensure_unique();
-		return buf_->data[0];
+		return buf_->data()[0];
 	}
 
-	const_reference front() const { return buf_->data[0]; }
+	const_reference front() const { return buf_->data()[0]; }
 
 	reference back() {
 		ensure_unique();
-		return buf_->data[buf_->size - 1];
+		return buf_->data()[buf_->size - 1];
 	}
 
-	const_reference back() const { return buf_->data[buf_->size - 1]; }
+	const_reference back() const { return buf_->data()[buf_->size - 1]; }
 
 	T* data() {
 		ensure_unique();
-		return buf_->data;
+		return buf_ ? buf_->data() : nullptr;
 	}
 
-	const T* data() const noexcept { return buf_ ? buf_->data : nullptr; }
+	const T* data() const noexcept { return buf_ ? buf_->data() : nullptr; }
+
+	// Write session: detaches from any sharer once and hands out raw mutable
+	// access to every element, so bulk loops skip the per-access uniqueness check
+	// of operator[]/begin()/end(). The span is invalidated by anything that
+	// reallocates, and writes through it are visible to copies made afterwards --
+	// finish writing before sharing the vector again.
+	std::span<T> mutable_span() {
+		ensure_unique();
+		return buf_ ? std::span<T>(buf_->data(), buf_->size) : std::span<T>();
+	}
 
 	// Iterators
 	iterator begin() {
 		ensure_unique();
-		return iterator(buf_->data);
+		return iterator(buf_ ? buf_->data() : nullptr);
 	}
 
-	const_iterator begin() const noexcept { return const_iterator(buf_ ? buf_->data : nullptr); }
+	const_iterator begin() const noexcept { return const_iterator(data()); }
 
-	const_iterator cbegin() const noexcept { return const_iterator(buf_ ? buf_->data : nullptr); }
+	const_iterator cbegin() const noexcept { return const_iterator(data()); }
 
 	iterator end() {
 		ensure_unique();
-		return iterator(buf_->data + buf_->size);
+		return iterator(buf_ ? buf_->data() + buf_->size : nullptr);
 	}
 
-	const_iterator end() const noexcept { return const_iterator(buf_ ? buf_->data + buf_->size : nullptr); }
+	const_iterator end() const noexcept { return const_iterator(buf_ ? buf_->data() + buf_->size : nullptr); }
 
-	const_iterator cend() const noexcept { return const_iterator(buf_ ? buf_->data + buf_->size : nullptr); }
+	const_iterator cend() const noexcept { return end(); }
 
 	// Capacity
 	bool empty() const noexcept { return !buf_ || buf_->size == 0; }
@@ -349,55 +514,52 @@ class CowVector {
 	}
 
 	void shrink_to_fit() {
-		if (buf_ && buf_->capacity > buf_->size) {
-			ensure_unique();
-			if (buf_->size == 0) {
-				if (buf_->data) {
-					std::free(buf_->data);
-					buf_->data = nullptr;
-				}
-				buf_->capacity = 0;
-			}
-			else {
-				T* new_data = static_cast<T*>(aligned_alloc(alignof(T), sizeof(T) * buf_->size));
-				for (size_t i = 0; i < buf_->size; ++i) {
-					new (new_data + i) T(std::move(buf_->data[i]));
-					buf_->data[i].~T();
-				}
-				std::free(buf_->data);
-				buf_->data = new_data;
-				buf_->capacity = buf_->size;
-			}
+		if (!buf_ || buf_->capacity == buf_->size) {
+			return;
+		}
+		if (buf_->size == 0) {
+			_release(buf_);
+			buf_ = nullptr;
+			return;
 		}
+
+		_rebuffer(buf_->size);
 	}
 
 	// Modifiers
 	void clear() noexcept {
-		if (buf_ && buf_->size > 0) {
-			ensure_unique();
-			for (size_t i = 0; i < buf_->size; ++i) {
-				buf_->data[i].~T();
-			}
+		if (!buf_ || buf_->size == 0) {
+			return;
+		}
+		if (_is_unique()) {
+			_destroy(buf_->data(), buf_->size);
 			buf_->size = 0;
 		}
+		else {
+			// Nothing to copy: detach into an empty buffer of the same capacity, so
+			// refilling it (e.g. a per-frame scene rebuild) doesn't regrow from scratch.
+			header* new_buf = _allocate(buf_->capacity, resource_);
+			_release(buf_);
+			buf_ = new_buf;
+		}
 	}
 
 	void push_back(const T& value) {
 		ensure_capacity(size() + 1);
-		new (buf_->data + buf_->size) T(value);
+		new (buf_->data() + buf_->size) T(value);
 		++buf_->size;
 	}
 
 	void push_back(T&& value) {
 		ensure_capacity(size() + 1);
-		new (buf_->data + buf_->size) T(std::move(value));
+		new (buf_->data() + buf_->size) T(std::move(value));
 		++buf_->size;
 	}
 
 	template <typename... Args>
 	reference emplace_back(Args&&... args) {
 		ensure_capacity(size() + 1);
-		T* ptr = buf_->data + buf_->size;
+		T* ptr = buf_->data() + buf_->size;
 		new (ptr) T(std::forward<Args>(args)...);
 		++buf_->size;
 		return *ptr;
@@ -407,7 +569,7 @@ class CowVector {
 		if (buf_ && buf_->size > 0) {
 			ensure_unique();
 			--buf_->size;
-			buf_->data[buf_->size].~T();
+			buf_->data()[buf_->size].~T();
 		}
 	}
 
@@ -417,24 +579,32 @@ class CowVector {
 		if (count > size()) {
 			ensure_capacity(count);
 			for (size_t i = buf_->size; i < count; ++i) {
-				new (buf_->data + i) T(value);
+				new (buf_->data() + i) T(value);
 			}
+			buf_->size = count;
 		}
 		else if (count < size()) {
 			ensure_unique();
-			for (size_t i = count; i < buf_->size; ++i) {
-				buf_->data[i].~T();
-			}
+			_destroy(buf_->data() + count, buf_->size - count);
+			buf_->size = count;
 		}
-		buf_->size = count;
 	}
 
+	std::pmr::memory_resource* get_memory_resource() const noexcept { return resource_; }
+
+	// Affects future allocations only; a current buffer stays where it is until
+	// the vector reallocates or detaches.
+	void set_memory_resource(std::pmr::memory_resource* resource) noexcept { resource_ = resource; }
+
 	// COW-specific method to check if buffer is shared
-	bool is_shared() const noexcept { return buf_ && buf_.use_count() > 1; }
+	bool is_shared() const noexcept { return use_count() > 1; }
+
+	size_t use_count() const noexcept { return buf_ ? buf_->refs().load(std::memory_order_relaxed) : 0; }
 
-	size_t use_count() const noexcept { return buf_ ? buf_.use_count() : 0; }
+	operator std::span<T>() const noexcept { return buf_ ? std::span(buf_->data(), buf_->size) : std::span<T>(); }
 
-	operator std::span<T>() const noexcept { return std::span(buf_->data, size()); }
+	template <typename U>
+	friend void swap(CowVector<U>& lhs, CowVector<U>& rhs) noexcept;
 };
 
 // Non-member functions
@@ -458,6 +628,7 @@ bool operator<(const CowVector<T>& lhs, const CowVector<T>& rhs) {
 template <typename T>
 void swap(CowVector<T>& lhs, CowVector<T>& rhs) noexcept {
 	std::swap(lhs.buf_, rhs.buf_);
+	std::swap(lhs.resource_, rhs.resource_);
 }
 
 } //namespace feather
\ No newline at end of file
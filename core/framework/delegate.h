@@ -1,10 +1,13 @@
 #pragma once
 
 #include "container_utils.h"
-#include "static_indexed_array.h"
+#include "slot_map.h"
 
+#include <algorithm>
 #include <functional>
 #include <ranges>
+#include <utility>
+#include <vector>
 
 namespace feather {
 
@@ -12,29 +15,112 @@ template <class... Args>
 class Delegate {
 public:
 	using DelegateFuncType = std::function<void(Args...)>;
-	StaticIndexedArray<DelegateFuncType> listeners;
 
-	using id_t = int32_t;
+	struct Listener {
+		DelegateFuncType callback;
+		// Removed from inside execute(); skipped until the next compact()
+		bool pending_removal = false;
+	};
+
+	// Listeners churn a lot; the slot map keeps subscribe/remove O(1) and lets
+	// execute() walk only live callbacks.
+	SlotMap<Listener> listeners;
+
+	using id_t = typename SlotMap<Listener>::handle_t;
+	static constexpr id_t invalid_id = SlotMap<Listener>::invalid_handle;
+
+private:
+	// While any execute() runs, subscribe() only reserves an id and remove() only
+	// flags the listener, so the packed storage never moves under a running
+	// callback. Both are applied when the outermost execute() returns.
+	std::vector<std::pair<id_t, DelegateFuncType>> _pending_subscriptions;
+	std::vector<id_t> _pending_removals;
+	uint32_t _execute_depth = 0;
+
+	void _apply_deferred() {
+		for (auto& [id, callback] : _pending_subscriptions) {
+			listeners.emplace_reserved(id, Listener { .callback = std::move(callback) });
+		}
+		_pending_subscriptions.clear();
+		compact();
+	}
 
 public:
-	id_t subscribe(const DelegateFuncType& callback) { return listeners.add(callback); }
+	// From inside execute(), the new listener runs from the next execute() on
+	id_t subscribe(const DelegateFuncType& callback) {
+		if (_execute_depth > 0) {
+			const id_t id = listeners.reserve_handle();
+			_pending_subscriptions.emplace_back(id, callback);
+			return id;
+		}
+		return listeners.add({ .callback = callback });
+	}
 
 	void execute(const Args&... args) {
 		if (listeners.empty())
 			return;
-		for (auto&& l : listeners) {
-			l(std::forward<Args>(args)...);
+
+		// Also unwinds a throwing callback, so the deferred changes still land
+		struct DepthGuard {
+			Delegate& delegate;
+			~DepthGuard() {
+				if (--delegate._execute_depth == 0)
+					delegate._apply_deferred();
+			}
+		};
+		++_execute_depth;
+		const DepthGuard guard { *this };
+
+		for (size_t i = 0; i < listeners.size(); ++i) {
+			const Listener& listener = listeners.data()[i];
+			if (!listener.pending_removal)
+				listener.callback(std::forward<const Args&>(args)...);
 		}
 	}
 
+	// Stale or already removed ids are ignored
 	void remove(id_t id) {
-		if (id < 0 || !listeners.has_value(id))
+		if (!listeners.has_value(id)) {
+			auto pending = std::ranges::find(_pending_subscriptions, id, &std::pair<id_t, DelegateFuncType>::first);
+			if (pending != _pending_subscriptions.end()) {
+				listeners.release_reserved(id);
+				_pending_subscriptions.erase(pending);
+			}
+			return;
+		}
+		if (listeners[id].pending_removal)
 			return;
 
+		if (_execute_depth > 0) {
+			listeners[id].pending_removal = true;
+			_pending_removals.push_back(id);
+			return;
+		}
+
 		listeners.remove(id);
 	}
 
-	void clear() { listeners.clear(); }
+	// Applies deferred removals. Runs automatically after an execute() that
+	// removed listeners; only call it between executions.
+	void compact() {
+		fassert(_execute_depth == 0, "Delegate compacted while executing");
+		for (id_t id : _pending_removals) {
+			listeners.remove(id);
+		}
+		_pending_removals.clear();
+	}
+
+	// Releases storage left over from listener churn; never done automatically
+	void shrink_to_fit() {
+		compact();
+		listeners.shrink_to_fit();
+	}
+
+	void clear() {
+		fassert(_execute_depth == 0, "Delegate cleared while executing");
+		listeners.clear();
+		_pending_removals.clear();
+	}
 };
 
 } // namespace feather
\ No newline at end of file
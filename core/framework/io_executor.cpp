@@ -0,0 +1,94 @@
+#include "io_executor.h"
+
+#include "alloc_tracker.h"
+#include "assert.h"
+#include "job_system.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace feather {
+
+IoExecutor* IoExecutor::_instance = nullptr;
+
+IoExecutor::IoExecutor(int thread_count) {
+	fassert(!_instance, "IoExecutor already exists");
+	_instance = this;
+
+	thread_count = std::max(thread_count, 1);
+	_threads.reserve(thread_count);
+	for (int i = 0; i < thread_count; ++i) {
+		_threads.emplace_back(&IoExecutor::_thread_main, this);
+	}
+}
+
+IoExecutor::~IoExecutor() {
+	{
+		std::lock_guard lock(_mutex);
+		_stop = true;
+	}
+	_cv.notify_all();
+	_threads.clear();
+	_instance = nullptr;
+}
+
+IoExecutor* IoExecutor::get() {
+	return _instance;
+}
+
+void IoExecutor::_thread_main() {
+	AllocTagScope tag { AllocTag::framework };
+	Profiler::set_thread_name("I/O");
+	while (true) {
+		Request* request;
+		{
+			std::unique_lock lock(_mutex);
+			_cv.wait(lock, [this] { return _stop || !_requests.empty(); });
+			if (_requests.empty())
+				return;
+			request = _requests.front();
+			_requests.pop_front();
+		}
+		{
+			FPROFILE_ZONE("IoExecutor::read_file");
+			request->result = read_file_now(request->path);
+		}
+		_complete(request);
+	}
+}
+
+void IoExecutor::_submit(Request* request) {
+	{
+		std::lock_guard lock(_mutex);
+		_requests.push_back(request);
+	}
+	_cv.notify_one();
+}
+
+void IoExecutor::_complete(Request* request) {
+	// The request lives in the coroutine frame: nothing may touch it after resuming
+	std::coroutine_handle<> waiter = request->waiter;
+	if (JobSystem* jobs = JobSystem::get())
+		jobs->post([waiter] { waiter.resume(); });
+	else
+		waiter.resume();
+}
+
+std::optional<std::vector<std::byte>> IoExecutor::read_file_now(const Path& path) {
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file)
+		return std::nullopt;
+
+	const std::streamsize size = file.tellg();
+	if (size < 0)
+		return std::nullopt;
+	file.seekg(0);
+
+	std::vector<std::byte> data(static_cast<size_t>(size));
+	if (!file.read(reinterpret_cast<char*>(data.data()), size))
+		return std::nullopt;
+	return data;
+}
+
+} // namespace feather
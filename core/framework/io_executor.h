@@ -0,0 +1,71 @@
+#pragma once
+
+#include "path.h"
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace feather {
+
+// Runs blocking file I/O on a few dedicated threads, so coroutines can await it
+// without holding a job worker or the main thread:
+//
+//	std::optional<std::vector<std::byte>> bytes = co_await IoExecutor::get()->read_file(path);
+//
+// The awaiting coroutine resumes as a job on the JobSystem (or on the I/O
+// thread when there is none), so decoding what was read runs in parallel with
+// the next reads. Requests still queued on destruction are completed first.
+class IoExecutor {
+	static IoExecutor* _instance;
+
+	struct Request {
+		Path path;
+		std::optional<std::vector<std::byte>> result;
+		std::coroutine_handle<> waiter;
+	};
+
+	std::vector<std::jthread> _threads;
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	std::deque<Request*> _requests;
+	bool _stop = false;
+
+	void _thread_main();
+	void _submit(Request* request);
+	static void _complete(Request* request);
+
+public:
+	struct ReadAwaiter {
+		IoExecutor& executor;
+		Request request;
+
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(std::coroutine_handle<> handle) {
+			request.waiter = handle;
+			executor._submit(&request);
+		}
+		std::optional<std::vector<std::byte>> await_resume() { return std::move(request.result); }
+	};
+
+	explicit IoExecutor(int thread_count = 2);
+	~IoExecutor();
+
+	IoExecutor(const IoExecutor&) = delete;
+	IoExecutor& operator=(const IoExecutor&) = delete;
+
+	static IoExecutor* get();
+
+	// Whole file contents, or nothing if it couldn't be read
+	[[nodiscard]] ReadAwaiter read_file(Path path) { return { *this, { std::move(path), std::nullopt, nullptr } }; }
+
+	// Blocking read on the calling thread, for callers outside coroutines
+	static std::optional<std::vector<std::byte>> read_file_now(const Path& path);
+};
+
+} // namespace feather
@@ -0,0 +1,191 @@
+#include "job_system.h"
+
+#include "assert.h"
+#include "profiler.h"
+#include "spinlock.h"
+
+#include <format>
+
+namespace feather {
+
+namespace {
+
+// Deque slot of the current thread, valid while tls_system matches
+thread_local const JobSystem* tls_system = nullptr;
+thread_local uint32_t tls_index = 0;
+
+// Failed searches before an idle worker goes to sleep
+constexpr uint32_t idle_spins = 64;
+
+} // namespace
+
+JobSystem* JobSystem::_instance = nullptr;
+
+TaskGroup::~TaskGroup() {
+	fassert(is_done(), "TaskGroup destroyed with jobs still pending");
+}
+
+JobSystem::JobSystem(int worker_count) {
+	fassert(!_instance, "JobSystem already exists");
+	_instance = this;
+
+	if (worker_count < 0)
+		worker_count = std::max<int>(static_cast<int>(std::thread::hardware_concurrency()) - 1, 0);
+
+	for (int i = 0; i <= worker_count; ++i) {
+		_deques.push_back(std::make_unique<WorkStealingDeque<Job*>>());
+	}
+	tls_system = this;
+	tls_index = 0;
+
+	_workers.reserve(worker_count);
+	for (int i = 1; i <= worker_count; ++i) {
+		_workers.emplace_back(&JobSystem::_worker_main, this, static_cast<uint32_t>(i));
+	}
+}
+
+JobSystem::~JobSystem() {
+	{
+		std::lock_guard lock(_sleep_mutex);
+		_stop.store(true, std::memory_order_seq_cst);
+	}
+	_wake_cv.notify_all();
+	_workers.clear();
+
+	// Workers leave as soon as they see _stop; whatever they left behind (and
+	// whatever that submits) runs here
+	while (Job* job = _find_job()) {
+		_execute(job);
+	}
+
+	fassert(_queued.load() == 0, "JobSystem destroyed with jobs still queued");
+	if (tls_system == this)
+		tls_system = nullptr;
+	_instance = nullptr;
+}
+
+JobSystem* JobSystem::get() {
+	return _instance;
+}
+
+void JobSystem::_worker_main(uint32_t index) {
+	tls_system = this;
+	tls_index = index;
+	Profiler::set_thread_name(std::format("Job Worker {}", index));
+
+	uint32_t spins = 0;
+	while (!_stop.load(std::memory_order_acquire)) {
+		if (Job* job = _find_job()) {
+			_execute(job);
+			spins = 0;
+			continue;
+		}
+		if (++spins < idle_spins) {
+			Pause();
+			continue;
+		}
+
+		// _sleeping and _queued are both seq_cst, so either this worker sees the
+		// new job or the submitter sees it sleeping and wakes it
+		std::unique_lock lock(_sleep_mutex);
+		_sleeping.fetch_add(1, std::memory_order_seq_cst);
+		_wake_cv.wait(lock, [this] {
+			return _queued.load(std::memory_order_seq_cst) > 0 || _stop.load(std::memory_order_relaxed);
+		});
+		_sleeping.fetch_sub(1, std::memory_order_relaxed);
+		spins = 0;
+	}
+}
+
+void JobSystem::_submit(Job* job) {
+	_queued.fetch_add(1, std::memory_order_seq_cst);
+	if (tls_system == this) {
+		_deques[tls_index]->push(job);
+	}
+	else {
+		std::lock_guard lock(_shared_mutex);
+		_shared_jobs.push_back(job);
+	}
+
+	if (_sleeping.load(std::memory_order_seq_cst) > 0) {
+		std::lock_guard lock(_sleep_mutex);
+		_wake_cv.notify_one();
+	}
+}
+
+JobSystem::Job* JobSystem::_find_job() {
+	const bool owns_deque = tls_system == this;
+	const uint32_t self = owns_deque ? tls_index : 0;
+
+	Job* job = owns_deque ? _deques[self]->pop() : nullptr;
+
+	if (!job) {
+		std::unique_lock lock(_shared_mutex, std::try_to_lock);
+		if (lock && !_shared_jobs.empty()) {
+			job = _shared_jobs.front();
+			_shared_jobs.pop_front();
+		}
+	}
+
+	// Start at the next deque so thieves spread over the victims
+	const size_t count = _deques.size();
+	for (size_t i = 1; !job && i <= count; ++i) {
+		const size_t victim = (self + i) % count;
+		if (!owns_deque || victim != self)
+			job = _deques[victim]->steal();
+	}
+
+	if (job)
+		_queued.fetch_sub(1, std::memory_order_relaxed);
+	return job;
+}
+
+void JobSystem::_execute(Job* job) {
+	job->function();
+	TaskGroup* group = job->group;
+	delete job;
+	if (group)
+		_finish_job(*group);
+}
+
+void JobSystem::_finish_job(TaskGroup& group) {
+	const uint32_t left = group._pending.fetch_sub(2, std::memory_order_acq_rel) - 2;
+	if (left != 1)
+		return;
+
+	// Only the continuation is left; it becomes a regular job of the group
+	group._pending.fetch_add(1, std::memory_order_relaxed);
+	_submit(new Job { .function = std::move(group._continuation), .group = &group });
+}
+
+void JobSystem::then(TaskGroup& group, std::move_only_function<void()> continuation) {
+	fassert(!(group._pending.load(std::memory_order_relaxed) & 1), "TaskGroup already has a continuation");
+	// Published by the release below to whichever job finishes last
+	group._continuation = std::move(continuation);
+	if (group._pending.fetch_add(1, std::memory_order_acq_rel) == 0) {
+		group._pending.fetch_add(1, std::memory_order_relaxed);
+		_submit(new Job { .function = std::move(group._continuation), .group = &group });
+	}
+}
+
+void JobSystem::run_pending() {
+	while (Job* job = _find_job()) {
+		_execute(job);
+	}
+}
+
+void JobSystem::_help(uint32_t& spins) {
+	if (Job* job = _find_job()) {
+		_execute(job);
+		spins = 0;
+	}
+	else if (++spins < idle_spins) {
+		Pause();
+	}
+	else {
+		// The remaining jobs are running elsewhere
+		std::this_thread::yield();
+	}
+}
+
+} // namespace feather
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "work_stealing_deque.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace feather {
+
+class JobSystem;
+
+// Jobs submitted through JobSystem::run. A group must be waited on (or be
+// otherwise known to be done) before it is destroyed.
+class TaskGroup {
+	friend class JobSystem;
+
+	// Two per pending job, plus one while a continuation waits for them; keeping
+	// both in one counter lets exactly one finishing job see that only the
+	// continuation is left
+	std::atomic<uint32_t> _pending { 0 };
+	std::move_only_function<void()> _continuation;
+
+public:
+	TaskGroup() = default;
+	~TaskGroup();
+
+	TaskGroup(const TaskGroup&) = delete;
+	TaskGroup& operator=(const TaskGroup&) = delete;
+
+	[[nodiscard]] bool is_done() const { return _pending.load(std::memory_order_acquire) == 0; }
+};
+
+// Work-stealing thread pool. Every worker owns a Chase-Lev deque: it runs its
+// own jobs newest first and steals the oldest ones from the others when it runs
+// dry. The thread that created the pool owns a deque too, so a job it submits
+// stays local until a worker steals it, and wait() runs jobs instead of
+// blocking. Other threads submit through a shared queue.
+//
+// Idle workers spin briefly, then sleep until new work arrives.
+class JobSystem {
+	static JobSystem* _instance;
+
+	struct Job {
+		std::move_only_function<void()> function;
+		TaskGroup* group;
+	};
+
+	// Slot 0 belongs to the creating thread, then one per worker
+	std::vector<std::unique_ptr<WorkStealingDeque<Job*>>> _deques;
+	std::vector<std::jthread> _workers;
+
+	// Submissions from threads that own no deque
+	std::mutex _shared_mutex;
+	std::deque<Job*> _shared_jobs;
+
+	// Jobs submitted but not yet taken; sleeping workers wake when it rises
+	std::atomic<int64_t> _queued { 0 };
+	std::atomic<uint32_t> _sleeping { 0 };
+	std::mutex _sleep_mutex;
+	std::condition_variable _wake_cv;
+	std::atomic<bool> _stop { false };
+
+	void _worker_main(uint32_t index);
+	void _submit(Job* job);
+	Job* _find_job();
+	void _execute(Job* job);
+	void _finish_job(TaskGroup& group);
+	// One step of a waiting thread: runs a job, or spins or yields if there is none
+	void _help(uint32_t& spins);
+
+	template <class F>
+	void _split_range(TaskGroup& group, size_t begin, size_t end, size_t grain, F& function) {
+		// Hand the upper halves out, so thieves take large ranges and split them further
+		while (end - begin > grain) {
+			const size_t mid = begin + (end - begin) / 2;
+			run(group, [this, &group, mid, end, grain, &function] { _split_range(group, mid, end, grain, function); });
+			end = mid;
+		}
+		if (begin < end)
+			function(begin, end);
+	}
+
+public:
+	// A negative worker_count means one worker per hardware thread besides the
+	// creating one. With 0 workers, jobs run in wait().
+	explicit JobSystem(int worker_count = -1);
+	// Jobs still queued run on the destroying thread before it returns
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	static JobSystem* get();
+
+	[[nodiscard]] uint32_t get_worker_count() const { return static_cast<uint32_t>(_workers.size()); }
+
+	template <class F>
+	void run(TaskGroup& group, F&& function) {
+		group._pending.fetch_add(2, std::memory_order_relaxed);
+		_submit(new Job { .function = std::forward<F>(function), .group = &group });
+	}
+
+	// Fire and forget: no group tracks the job, so whatever it touches must
+	// outlive it by other means (e.g. resuming a coroutine that owns itself)
+	template <class F>
+	void post(F&& function) {
+		_submit(new Job { .function = std::forward<F>(function), .group = nullptr });
+	}
+
+	// Runs continuation once every job of the group is done, as a job of the
+	// group itself, so wait() also covers it. Jobs must not be added to the group
+	// afterwards, except from its own jobs.
+	void then(TaskGroup& group, std::move_only_function<void()> continuation);
+
+	// Runs other jobs until the group is done
+	void wait(TaskGroup& group) {
+		wait_until([&group] { return group.is_done(); });
+	}
+
+	// Runs other jobs until done() returns true
+	template <class F>
+	void wait_until(F&& done) {
+		uint32_t spins = 0;
+		while (!done()) {
+			_help(spins);
+		}
+	}
+
+	// Runs queued jobs until there are none left, without waiting for the ones
+	// running elsewhere. With no workers, a thread that polls for results
+	// (Task::start() then is_done()) has to call this to make progress.
+	void run_pending();
+
+	// Calls function(first, last) over [begin, end) in ranges of at most grain
+	// indices, and returns once they are all done
+	template <class F>
+	void parallel_for(size_t begin, size_t end, size_t grain, F&& function) {
+		TaskGroup group;
+		_split_range(group, begin, end, std::max<size_t>(grain, 1), function);
+		wait(group);
+	}
+};
+
+} // namespace feather
@@ -0,0 +1,124 @@
+#include "linear_arena.h"
+
+#include "alloc_tracker.h"
+#include "assert.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace feather {
+
+LinearArena::LinearArena(size_t block_size, std::pmr::memory_resource* upstream)
+		: _upstream(upstream)
+		, _block_size(block_size)
+		, _blocks(upstream) {
+}
+
+LinearArena::~LinearArena() {
+	fassert(live_allocations() == 0, "LinearArena destroyed with live allocations");
+	for (const Block& block : _blocks) {
+		_upstream->deallocate(block.data, block.size, alignof(std::max_align_t));
+	}
+}
+
+void LinearArena::reset() {
+	fassert(live_allocations() == 0, "LinearArena reset with live allocations");
+	_current_block = 0;
+	_offset = 0;
+	_bytes_used = 0;
+}
+
+bool LinearArena::try_reset() {
+	if (live_allocations() != 0)
+		return false;
+	reset();
+	return true;
+}
+
+LinearArena::Marker LinearArena::get_marker() const noexcept {
+	return Marker { .block = _current_block,
+					.offset = _offset,
+					.bytes_used = _bytes_used,
+					.live_allocations = live_allocations() };
+}
+
+void LinearArena::rewind(const Marker& marker) {
+	fassert(live_allocations() == marker.live_allocations, "LinearArena rewound past live allocations");
+	_current_block = marker.block;
+	_offset = marker.offset;
+	_bytes_used = marker.bytes_used;
+}
+
+LinearArena::Stats LinearArena::get_stats() const noexcept {
+	size_t reserved = 0;
+	for (const Block& block : _blocks) {
+		reserved += block.size;
+	}
+	return Stats { .upstream_allocations = _upstream_allocations,
+				   .bytes_reserved = reserved,
+				   .bytes_used = _bytes_used,
+				   .high_water_mark = _high_water_mark };
+}
+
+void* LinearArena::do_allocate(size_t bytes, size_t alignment) {
+	// Walk the retained blocks first; only a request none of them can hold grows the arena
+	while (_current_block < _blocks.size()) {
+		const Block& block = _blocks[_current_block];
+		// Align the address, not the offset: blocks are only max_align_t aligned
+		const auto base = reinterpret_cast<uintptr_t>(block.data);
+		const size_t aligned = ((base + _offset + alignment - 1) & ~(alignment - 1)) - base;
+		if (aligned + bytes <= block.size) {
+			_offset = aligned + bytes;
+			_bytes_used += bytes;
+			_high_water_mark = std::max(_high_water_mark, _bytes_used);
+			_live_allocations.fetch_add(1, std::memory_order_relaxed);
+			return block.data + aligned;
+		}
+		++_current_block;
+		_offset = 0;
+	}
+
+	size_t size = std::max(_block_size, bytes + alignment);
+	auto* data = static_cast<std::byte*>(_upstream->allocate(size, alignof(std::max_align_t)));
+	++_upstream_allocations;
+	_blocks.push_back({ .data = data, .size = size });
+	_current_block = _blocks.size() - 1;
+	_offset = 0;
+	return do_allocate(bytes, alignment);
+}
+
+void LinearArena::do_deallocate(void* p, size_t bytes, size_t alignment) {
+	// Memory is only reclaimed as a whole by reset()
+	_live_allocations.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+FrameArena::FrameArena(size_t frames_in_flight, size_t block_size) {
+	fassert(frames_in_flight > 0, "FrameArena needs at least one frame");
+	for (size_t i = 0; i < frames_in_flight; ++i) {
+		_arenas.push_back(std::make_unique<LinearArena>(block_size));
+	}
+}
+
+void FrameArena::begin_frame() {
+	_current = (_current + 1) % _arenas.size();
+	_arenas[_current]->reset();
+}
+
+namespace {
+
+LinearArena& thread_scratch_arena() {
+	// Blocks are kept for the thread's lifetime; the main thread's outlive main()
+	thread_local LinearArena arena(64 * 1024, get_permanent_memory_resource());
+	return arena;
+}
+
+} // namespace
+
+ScratchScope::ScratchScope() : _arena(thread_scratch_arena()), _marker(_arena.get_marker()) {
+}
+
+ScratchScope::~ScratchScope() {
+	_arena.rewind(_marker);
+}
+
+} // namespace feather
\ No newline at end of file
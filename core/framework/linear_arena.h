@@ -0,0 +1,187 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace feather {
+
+// Bump allocator over a list of blocks that are kept across reset(), so once it
+// has grown to a workload's high-water mark, rewinding and refilling it never
+// reaches the upstream heap again. Meant for data rebuilt every frame.
+//
+// Allocation and reset() must happen on a single thread; deallocate() only
+// updates the live-allocation count and may come from any thread (e.g. the render
+// thread dropping the last reference to a CowVector buffer).
+class LinearArena : public std::pmr::memory_resource {
+public:
+	struct Stats {
+		// Blocks requested from upstream over the arena's lifetime
+		size_t upstream_allocations = 0;
+		size_t bytes_reserved = 0;
+		size_t bytes_used = 0;
+		size_t high_water_mark = 0;
+	};
+
+	// Position to rewind() back to
+	struct Marker {
+		size_t block;
+		size_t offset;
+		size_t bytes_used;
+		size_t live_allocations;
+	};
+
+	explicit LinearArena(size_t block_size = 64 * 1024,
+						 std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+	~LinearArena() override;
+
+	LinearArena(const LinearArena&) = delete;
+	LinearArena& operator=(const LinearArena&) = delete;
+
+	// Rewinds to the first block. Every allocation must have been released.
+	void reset();
+	// reset() if nothing allocated from the arena is still alive
+	bool try_reset();
+
+	Marker get_marker() const noexcept;
+	// Releases everything allocated since the marker was taken, which must all
+	// have been deallocated already
+	void rewind(const Marker& marker);
+
+	size_t live_allocations() const noexcept { return _live_allocations.load(std::memory_order_acquire); }
+	Stats get_stats() const noexcept;
+
+protected:
+	// Final, so calls through a LinearArena (see ArenaAllocator) aren't virtual
+	void* do_allocate(size_t bytes, size_t alignment) final;
+	void do_deallocate(void* p, size_t bytes, size_t alignment) final;
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+	struct Block {
+		std::byte* data;
+		size_t size;
+	};
+
+	std::pmr::memory_resource* _upstream;
+	size_t _block_size;
+	// Allocated from upstream too, so an arena never touches the general heap on its own
+	std::pmr::vector<Block> _blocks;
+	size_t _current_block = 0;
+	size_t _offset = 0;
+
+	std::atomic<size_t> _live_allocations { 0 };
+	size_t _upstream_allocations = 0;
+	size_t _bytes_used = 0;
+	size_t _high_water_mark = 0;
+};
+
+// Minimal STL allocator over a LinearArena. Unlike a pmr::polymorphic_allocator
+// it calls the arena directly rather than through memory_resource's virtuals.
+template <class T>
+class ArenaAllocator {
+	LinearArena* _arena;
+
+public:
+	using value_type = T;
+
+	explicit ArenaAllocator(LinearArena& arena) noexcept : _arena(&arena) {}
+	template <class U>
+	ArenaAllocator(const ArenaAllocator<U>& other) noexcept : _arena(&other.get_arena()) {}
+
+	T* allocate(size_t count) { return static_cast<T*>(_arena->allocate(count * sizeof(T), alignof(T))); }
+	void deallocate(T* p, size_t count) noexcept { _arena->deallocate(p, count * sizeof(T), alignof(T)); }
+
+	LinearArena& get_arena() const noexcept { return *_arena; }
+
+	template <class U>
+	bool operator==(const ArenaAllocator<U>& other) const noexcept {
+		return _arena == &other.get_arena();
+	}
+};
+
+template <class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// One LinearArena per frame in flight. begin_frame() moves on to the next one
+// and resets it, so whatever a frame allocated stays valid until the frame
+// comes around again, i.e. until the GPU is done with it.
+class FrameArena {
+public:
+	explicit FrameArena(size_t frames_in_flight = 3, size_t block_size = 256 * 1024);
+
+	void begin_frame();
+
+	LinearArena& get() noexcept { return *_arenas[_current]; }
+	template <class T>
+	ArenaAllocator<T> allocator() noexcept {
+		return ArenaAllocator<T>(get());
+	}
+
+private:
+	std::vector<std::unique_ptr<LinearArena>> _arenas;
+	size_t _current = 0;
+};
+
+// Per-thread stack of temporary memory. A scope rewinds the calling thread's
+// scratch arena to where it was when the scope opened, so containers built in
+// a loop body reuse the same bytes every iteration. Scopes nest; everything
+// allocated in one must be gone before it closes.
+class ScratchScope {
+public:
+	ScratchScope();
+	~ScratchScope();
+
+	ScratchScope(const ScratchScope&) = delete;
+	ScratchScope& operator=(const ScratchScope&) = delete;
+
+	LinearArena& get_arena() const noexcept { return _arena; }
+	template <class T>
+	ArenaAllocator<T> allocator() const noexcept {
+		return ArenaAllocator<T>(_arena);
+	}
+
+private:
+	LinearArena& _arena;
+	LinearArena::Marker _marker;
+};
+
+// Passes everything through to upstream, counting it. Placed under a pool, it
+// shows whether the pool still reaches the general heap once warmed up.
+class CountingResource : public std::pmr::memory_resource {
+public:
+	struct Stats {
+		size_t upstream_allocations = 0;
+		size_t bytes_reserved = 0;
+	};
+
+	explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) :
+			_upstream(upstream) {}
+
+	Stats get_stats() const noexcept {
+		return { .upstream_allocations = _allocations.load(std::memory_order_relaxed),
+				 .bytes_reserved = _bytes.load(std::memory_order_relaxed) };
+	}
+
+protected:
+	void* do_allocate(size_t bytes, size_t alignment) override {
+		void* p = _upstream->allocate(bytes, alignment);
+		_allocations.fetch_add(1, std::memory_order_relaxed);
+		_bytes.fetch_add(bytes, std::memory_order_relaxed);
+		return p;
+	}
+	void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+		_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+		_upstream->deallocate(p, bytes, alignment);
+	}
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+	std::pmr::memory_resource* _upstream;
+	std::atomic<size_t> _allocations { 0 };
+	std::atomic<size_t> _bytes { 0 };
+};
+
+} // namespace feather
\ No newline at end of file
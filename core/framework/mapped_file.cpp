@@ -0,0 +1,98 @@
+#include "mapped_file.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#elif defined(__APPLE__) || defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace feather {
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+bool MappedFile::open(const Path& path) {
+	close();
+
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+							  FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	// Empty files can't be mapped
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (!data) {
+		if (mapping)
+			CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	_file = file;
+	_mapping = mapping;
+	_data = static_cast<const std::byte*>(data);
+	_size = static_cast<size_t>(size.QuadPart);
+	return true;
+}
+
+void MappedFile::close() {
+	if (!_data)
+		return;
+
+	UnmapViewOfFile(_data);
+	CloseHandle(_mapping);
+	CloseHandle(_file);
+	_data = nullptr;
+	_size = 0;
+	_file = nullptr;
+	_mapping = nullptr;
+}
+#else
+bool MappedFile::open(const Path& path) {
+	close();
+
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat info;
+	// Empty files can't be mapped
+	if (fstat(fd, &info) != 0 || info.st_size == 0) {
+		::close(fd);
+		return false;
+	}
+
+	void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping keeps its own reference to the file
+	::close(fd);
+	if (data == MAP_FAILED)
+		return false;
+
+	_data = static_cast<const std::byte*>(data);
+	_size = static_cast<size_t>(info.st_size);
+	return true;
+}
+
+void MappedFile::close() {
+	if (!_data)
+		return;
+
+	munmap(const_cast<std::byte*>(_data), _size);
+	_data = nullptr;
+	_size = 0;
+}
+#endif
+
+} // namespace feather
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "path.h"
+
+#include <cstddef>
+#include <span>
+
+namespace feather {
+
+// Read-only memory mapping of a whole file. Views into get_data() (e.g. arrays
+// borrowed by a zero-copy BinaryReader) are only valid while the mapping is open.
+class MappedFile {
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool open(const Path& path);
+	void close();
+
+	[[nodiscard]] bool is_open() const { return _data != nullptr; }
+	[[nodiscard]] std::span<const std::byte> get_data() const { return { _data, _size }; }
+
+private:
+	const std::byte* _data = nullptr;
+	size_t _size = 0;
+#if defined(_WIN32) || defined(_WIN64)
+	void* _file = nullptr;
+	void* _mapping = nullptr;
+#endif
+};
+
+} // namespace feather
@@ -0,0 +1,102 @@
+#include "object_pool.h"
+
+#include "assert.h"
+#include "reflected.h"
+
+#include <algorithm>
+#include <new>
+
+namespace feather {
+
+void ObjectPool::Deleter::operator()(Reflected* object) const {
+	// The slot holds the most derived object, which may not start at its Reflected base
+	void* slot = dynamic_cast<void*>(object);
+	object->~Reflected();
+	pool->deallocate(slot);
+}
+
+ObjectPool::ObjectPool(size_t object_size, size_t object_alignment, size_t slab_size)
+		: _alignment(std::max(object_alignment, alignof(FreeSlot))) {
+	// Every slot must be able to hold a free-list link and keep the next slot aligned
+	_slot_size = std::max(object_size, sizeof(FreeSlot));
+	_slot_size = (_slot_size + _alignment - 1) / _alignment * _alignment;
+	_slab_slots = std::max<size_t>(1, slab_size / _slot_size);
+}
+
+ObjectPool::~ObjectPool() {
+	fassert(_live_objects == 0, "ObjectPool destroyed with live objects");
+	for (const Slab& slab : _slabs) {
+		::operator delete(slab.data, slab.size, std::align_val_t(_alignment));
+	}
+}
+
+void ObjectPool::_add_slab(size_t slot_count) {
+	const size_t size = slot_count * _slot_size;
+	std::byte* data = static_cast<std::byte*>(::operator new(size, std::align_val_t(_alignment)));
+	_slabs.push_back(Slab { .data = data, .size = size });
+	_cursor = data;
+	_cursor_slots = slot_count;
+}
+
+void ObjectPool::_release_cursor() {
+	// A run that doesn't fit abandons the current tail; keep its slots reachable
+	for (; _cursor_slots > 0; --_cursor_slots, _cursor += _slot_size) {
+		_free_list = new (_cursor) FreeSlot { _free_list };
+	}
+}
+
+void* ObjectPool::allocate() {
+	std::lock_guard lock(_mutex);
+	++_live_objects;
+
+	if (_free_list) {
+		FreeSlot* slot = _free_list;
+		_free_list = slot->next;
+		return slot;
+	}
+	if (_cursor_slots == 0) {
+		_add_slab(_slab_slots);
+	}
+	void* slot = _cursor;
+	_cursor += _slot_size;
+	--_cursor_slots;
+	return slot;
+}
+
+void* ObjectPool::allocate_run(size_t count) {
+	if (count == 0)
+		return nullptr;
+
+	std::lock_guard lock(_mutex);
+	_live_objects += count;
+
+	if (_cursor_slots < count) {
+		_release_cursor();
+		_add_slab(std::max(count, _slab_slots));
+	}
+	void* first = _cursor;
+	_cursor += count * _slot_size;
+	_cursor_slots -= count;
+	return first;
+}
+
+void ObjectPool::deallocate(void* slot) {
+	if (!slot)
+		return;
+
+	std::lock_guard lock(_mutex);
+	fassert(_live_objects > 0, "ObjectPool::deallocate without a live object");
+	--_live_objects;
+	_free_list = new (slot) FreeSlot { _free_list };
+}
+
+ObjectPool::Stats ObjectPool::get_stats() const {
+	std::lock_guard lock(_mutex);
+	size_t slots = 0;
+	for (const Slab& slab : _slabs) {
+		slots += slab.size / _slot_size;
+	}
+	return Stats { .slabs = _slabs.size(), .slots_reserved = slots, .live_objects = _live_objects };
+}
+
+} // namespace feather
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace feather {
+
+class Reflected;
+
+// Slot allocator for the objects of one class: fixed-size slots carved out of
+// contiguous slabs, with freed slots kept on an intrusive free list and reused
+// first. Slabs go back to the heap only when the pool is destroyed, so a pool
+// must outlive every object allocated from it. Thread-safe.
+class ObjectPool {
+public:
+	struct Stats {
+		size_t slabs = 0;
+		size_t slots_reserved = 0;
+		size_t live_objects = 0;
+	};
+
+	// Destroys a pooled object and returns its slot; see ClassDB::create_pooled_object
+	struct Deleter {
+		ObjectPool* pool = nullptr;
+
+		void operator()(Reflected* object) const;
+	};
+
+	ObjectPool(size_t object_size, size_t object_alignment, size_t slab_size = 16 * 1024);
+	~ObjectPool();
+
+	ObjectPool(const ObjectPool&) = delete;
+	ObjectPool& operator=(const ObjectPool&) = delete;
+
+	void* allocate();
+	// count adjacent slots, slot_size() bytes apart; each is deallocated on its own
+	void* allocate_run(size_t count);
+	void deallocate(void* slot);
+
+	size_t slot_size() const noexcept { return _slot_size; }
+	Stats get_stats() const;
+
+private:
+	struct FreeSlot {
+		FreeSlot* next;
+	};
+
+	struct Slab {
+		std::byte* data;
+		size_t size;
+	};
+
+	size_t _slot_size;
+	size_t _alignment;
+	size_t _slab_slots;
+
+	mutable std::mutex _mutex;
+	std::vector<Slab> _slabs;
+	FreeSlot* _free_list = nullptr;
+	// Never-used tail of the newest slab
+	std::byte* _cursor = nullptr;
+	size_t _cursor_slots = 0;
+	size_t _live_objects = 0;
+
+	void _add_slab(size_t slot_count);
+	void _release_cursor();
+};
+
+// Reflected object owned through its class's ObjectPool
+template <class T>
+using PooledObject = std::unique_ptr<T, ObjectPool::Deleter>;
+
+} // namespace feather
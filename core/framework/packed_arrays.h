@@ -0,0 +1,19 @@
+#pragma once
+
+#include "cow_vector.h"
+
+#include <math/math_defs.h>
+
+#include <cstdint>
+
+namespace feather {
+
+// Typed arrays that cross the Variant boundary as one COW buffer: passing or
+// returning them shares the buffer instead of converting every element
+using PackedByteArray = CowVector<uint8_t>;
+using PackedInt32Array = CowVector<int32_t>;
+using PackedFloat32Array = CowVector<float>;
+using PackedVector3Array = CowVector<Vector3>;
+using PackedVertexArray = CowVector<Vertex>;
+
+} // namespace feather
@@ -0,0 +1,206 @@
+#pragma once
+
+#include "cow_vector.h"
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+namespace feather {
+
+// Vector with structural sharing: elements live in fixed-size, individually
+// refcounted chunks, and the table of chunk pointers is itself a CowVector.
+// Copying is O(1); after a copy, writing to an element duplicates the chunk
+// table once (one pointer per ChunkSize elements) and then only the chunks that
+// are actually touched. Snapshots that mostly stay the same between frames thus
+// cost O(changed) instead of O(size).
+//
+// Reads are const-only; writes go through set()/push_back()/truncate(), so no
+// mutable reference can leak into a chunk shared with another copy. T only
+// needs to be copy-constructible.
+template <class T, size_t ChunkSize = 64>
+class PersistentVector {
+	static_assert(ChunkSize > 0);
+
+	struct Chunk {
+		std::atomic<size_t> ref_count;
+		size_t size;
+		std::pmr::memory_resource* resource;
+		alignas(T) std::byte storage[sizeof(T) * ChunkSize];
+
+		T* data() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+		const T* data() const noexcept { return std::launder(reinterpret_cast<const T*>(storage)); }
+	};
+
+	// Owning pointer to a chunk; copies share it
+	class ChunkRef {
+		Chunk* _chunk = nullptr;
+
+	public:
+		ChunkRef() = default;
+		explicit ChunkRef(Chunk* chunk) : _chunk(chunk) {}
+		ChunkRef(const ChunkRef& other) : _chunk(other._chunk) {
+			if (_chunk)
+				_chunk->ref_count.fetch_add(1, std::memory_order_relaxed);
+		}
+		ChunkRef(ChunkRef&& other) noexcept : _chunk(std::exchange(other._chunk, nullptr)) {}
+		ChunkRef& operator=(ChunkRef other) noexcept {
+			std::swap(_chunk, other._chunk);
+			return *this;
+		}
+		~ChunkRef() {
+			if (_chunk && _chunk->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				_free_chunk(_chunk);
+		}
+
+		Chunk* get() const noexcept { return _chunk; }
+		Chunk* operator->() const noexcept { return _chunk; }
+		bool is_unique() const noexcept { return _chunk->ref_count.load(std::memory_order_acquire) == 1; }
+	};
+
+	CowVector<ChunkRef> _chunks;
+	size_t _size = 0;
+	std::pmr::memory_resource* _resource = nullptr;
+
+	static Chunk* _allocate_chunk(std::pmr::memory_resource* resource) {
+		if (!resource)
+			resource = std::pmr::new_delete_resource();
+		void* memory = resource->allocate(sizeof(Chunk), alignof(Chunk));
+		Chunk* chunk = new (memory) Chunk;
+		chunk->ref_count.store(1, std::memory_order_relaxed);
+		chunk->size = 0;
+		chunk->resource = resource;
+		return chunk;
+	}
+
+	static void _free_chunk(Chunk* chunk) noexcept {
+		for (size_t i = 0; i < chunk->size; ++i) {
+			chunk->data()[i].~T();
+		}
+		std::pmr::memory_resource* resource = chunk->resource;
+		chunk->~Chunk();
+		resource->deallocate(chunk, sizeof(Chunk), alignof(Chunk));
+	}
+
+	// Chunk c, copied first if another vector still shares it
+	Chunk* _mutable_chunk(size_t c) {
+		// Non-const access detaches the chunk table itself if it is shared
+		ChunkRef& ref = _chunks[c];
+		if (!ref.is_unique()) {
+			Chunk* copy = _allocate_chunk(_resource);
+			for (size_t i = 0; i < ref->size; ++i) {
+				new (copy->data() + i) T(ref->data()[i]);
+				++copy->size;
+			}
+			ref = ChunkRef(copy);
+		}
+		return ref.get();
+	}
+
+public:
+	using value_type = T;
+	using size_type = size_t;
+
+	class const_iterator {
+		const ChunkRef* _chunk = nullptr;
+		size_t _offset = 0;
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = T;
+		using difference_type = ptrdiff_t;
+		using pointer = const T*;
+		using reference = const T&;
+
+		const_iterator() = default;
+		const_iterator(const ChunkRef* chunk, size_t offset) : _chunk(chunk), _offset(offset) {}
+
+		reference operator*() const { return (*_chunk)->data()[_offset]; }
+		pointer operator->() const { return &**this; }
+		const_iterator& operator++() {
+			if (++_offset == ChunkSize) {
+				++_chunk;
+				_offset = 0;
+			}
+			return *this;
+		}
+		const_iterator operator++(int) {
+			const_iterator tmp = *this;
+			++*this;
+			return tmp;
+		}
+
+		bool operator==(const const_iterator& other) const = default;
+	};
+
+	PersistentVector() = default;
+	explicit PersistentVector(std::pmr::memory_resource* resource) : _chunks(resource), _resource(resource) {}
+
+	size_type size() const noexcept { return _size; }
+	bool empty() const noexcept { return _size == 0; }
+
+	const T& operator[](size_type pos) const { return _chunks[pos / ChunkSize]->data()[pos % ChunkSize]; }
+	const T& front() const { return (*this)[0]; }
+	const T& back() const { return (*this)[_size - 1]; }
+
+	const_iterator begin() const noexcept { return const_iterator(_chunks.data(), 0); }
+	const_iterator end() const noexcept {
+		return const_iterator(_chunks.data() + _size / ChunkSize, _size % ChunkSize);
+	}
+
+	void reserve(size_type new_cap) { _chunks.reserve((new_cap + ChunkSize - 1) / ChunkSize); }
+
+	// Replaces the element at pos, copying only its chunk if it is shared
+	void set(size_type pos, const T& value) {
+		T* slot = _mutable_chunk(pos / ChunkSize)->data() + pos % ChunkSize;
+		// Destroy + construct rather than assign: T may hold const members
+		slot->~T();
+		new (slot) T(value);
+	}
+
+	void push_back(const T& value) {
+		if (_size % ChunkSize == 0) {
+			_chunks.push_back(ChunkRef(_allocate_chunk(_resource)));
+		}
+		Chunk* chunk = _mutable_chunk(_size / ChunkSize);
+		new (chunk->data() + chunk->size) T(value);
+		++chunk->size;
+		++_size;
+	}
+
+	// Drops every element from count onwards
+	void truncate(size_type count) {
+		if (count >= _size)
+			return;
+
+		const size_t chunk_count = (count + ChunkSize - 1) / ChunkSize;
+		_chunks.resize(chunk_count);
+		if (count % ChunkSize != 0) {
+			Chunk* chunk = _mutable_chunk(chunk_count - 1);
+			for (size_t i = count % ChunkSize; i < chunk->size; ++i) {
+				chunk->data()[i].~T();
+			}
+			chunk->size = count % ChunkSize;
+		}
+		_size = count;
+	}
+
+	void pop_back() { truncate(_size - 1); }
+
+	void clear() {
+		_chunks = CowVector<ChunkRef>(_resource);
+		_size = 0;
+	}
+
+	std::pmr::memory_resource* get_memory_resource() const noexcept { return _resource; }
+
+	void set_memory_resource(std::pmr::memory_resource* resource) noexcept {
+		_resource = resource;
+		_chunks.set_memory_resource(resource);
+	}
+};
+
+} // namespace feather
@@ -0,0 +1,182 @@
+#include "profiler.h"
+
+#include "alloc_tracker.h"
+#include "ring_queue.h"
+
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace feather {
+
+namespace {
+
+// Per thread: 32k events, 1 MiB
+constexpr size_t buffer_capacity = 1 << 15;
+
+struct ThreadBuffer {
+	SpscQueue<Profiler::Event> events { buffer_capacity };
+	uint32_t thread_id;
+	std::string name;
+	std::atomic<uint64_t> dropped { 0 };
+};
+
+// Buffers live until exit, so threads never see theirs disappear
+struct Session {
+	std::mutex buffers_mutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+	std::mutex file_mutex;
+	std::ofstream file;
+	bool first_event = true;
+};
+
+Session& session() {
+	static Session instance;
+	return instance;
+}
+
+thread_local ThreadBuffer* tls_buffer = nullptr;
+thread_local std::string tls_thread_name;
+
+ThreadBuffer& thread_buffer() {
+	if (!tls_buffer) {
+		Session& s = session();
+		std::lock_guard lock(s.buffers_mutex);
+		AllocTagScope tag { AllocTag::permanent };
+		auto buffer = std::make_unique<ThreadBuffer>();
+		buffer->thread_id = static_cast<uint32_t>(s.buffers.size());
+		buffer->name = tls_thread_name.empty() ? std::format("Thread {}", buffer->thread_id) : tls_thread_name;
+		tls_buffer = buffer.get();
+		s.buffers.push_back(std::move(buffer));
+	}
+	return *tls_buffer;
+}
+
+void write_escaped(std::ofstream& out, std::string_view str) {
+	for (char c : str) {
+		if (c == '"' || c == '\\')
+			out << '\\';
+		if (static_cast<unsigned char>(c) >= 0x20)
+			out << c;
+	}
+}
+
+void write_event(Session& s, const Profiler::Event& event, uint32_t thread_id) {
+	s.file << (s.first_event ? "\n" : ",\n");
+	s.first_event = false;
+	s.file << R"({"name":")";
+	write_escaped(s.file, event.name);
+	// Chrome trace timestamps are in microseconds
+	s.file << std::format(R"(","ph":"{}","ts":{:.3f},"pid":1,"tid":{})",
+						  event.type,
+						  static_cast<double>(event.timestamp) / 1000.0,
+						  thread_id);
+	if (event.type == 'X')
+		s.file << std::format(R"(,"dur":{:.3f})", static_cast<double>(event.duration) / 1000.0);
+	s.file << '}';
+}
+
+} // namespace
+
+bool Profiler::start(const Path& path) {
+	Session& s = session();
+	std::scoped_lock lock(s.buffers_mutex, s.file_mutex);
+	if (is_running())
+		return false;
+
+	s.file.open(path, std::ios::binary | std::ios::trunc);
+	if (!s.file) {
+		std::cerr << "Profiler: cannot open " << path << std::endl;
+		return false;
+	}
+	s.file << R"({"displayTimeUnit":"ms","traceEvents":[)";
+	s.first_event = true;
+
+	// Leftovers of an earlier session
+	Event discarded;
+	for (auto& buffer : s.buffers) {
+		while (buffer->events.try_pop(discarded)) {
+		}
+		buffer->dropped.store(0, std::memory_order_relaxed);
+	}
+
+	_epoch.store(static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()),
+				 std::memory_order_relaxed);
+	_running.store(true, std::memory_order_release);
+	return true;
+}
+
+void Profiler::stop() {
+	if (!_running.exchange(false, std::memory_order_acq_rel))
+		return;
+	flush();
+
+	Session& s = session();
+	std::scoped_lock lock(s.buffers_mutex, s.file_mutex);
+	uint64_t dropped = 0;
+	for (auto& buffer : s.buffers) {
+		s.file << (s.first_event ? "\n" : ",\n");
+		s.first_event = false;
+		s.file << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << buffer->thread_id
+			   << R"(,"args":{"name":")";
+		write_escaped(s.file, buffer->name);
+		s.file << R"("}})";
+		dropped += buffer->dropped.load(std::memory_order_relaxed);
+	}
+	s.file << "\n]}\n";
+	s.file.close();
+
+	if (dropped > 0)
+		std::cerr << "Profiler: " << dropped << " events dropped, buffers were full" << std::endl;
+}
+
+void Profiler::flush() {
+	Session& s = session();
+	std::scoped_lock lock(s.buffers_mutex, s.file_mutex);
+	if (!s.file.is_open())
+		return;
+
+	Event batch[256];
+	for (auto& buffer : s.buffers) {
+		while (const size_t count = buffer->events.try_pop_batch(batch)) {
+			for (const Event& event : std::span(batch, count)) {
+				write_event(s, event, buffer->thread_id);
+			}
+		}
+	}
+}
+
+void Profiler::set_thread_name(std::string name) {
+	if (tls_buffer) {
+		std::lock_guard lock(session().buffers_mutex);
+		tls_buffer->name = std::move(name);
+	}
+	else {
+		tls_thread_name = std::move(name);
+	}
+}
+
+void Profiler::record(const Event& event) {
+	ThreadBuffer& buffer = thread_buffer();
+	// flush() only polls, so there's no waiter to signal
+	if (!buffer.events.try_push<false>(event))
+		buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Profiler::begin(const char* name) {
+	if (is_running())
+		record({ .name = name, .timestamp = now(), .duration = 0, .type = 'B' });
+}
+
+void Profiler::end() {
+	if (is_running())
+		record({ .name = "", .timestamp = now(), .duration = 0, .type = 'E' });
+}
+
+} // namespace feather
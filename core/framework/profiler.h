@@ -0,0 +1,91 @@
+#pragma once
+
+#include "macro_utils.h"
+#include "path.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+// Zones are compiled out of release (PRODUCTION) builds
+#ifndef PRODUCTION
+#define FEATHER_PROFILER 1
+#else
+#define FEATHER_PROFILER 0
+#endif
+
+namespace feather {
+
+// Instrumentation profiler writing Chrome trace JSON, which chrome://tracing
+// and ui.perfetto.dev open.
+//
+// Every thread records into its own SPSC ring buffer, so recording never
+// takes a lock; flush(), called once per frame, drains the buffers into the
+// file. A thread that records faster than that drops events (counted, and
+// reported by stop()).
+class Profiler {
+public:
+	struct Event {
+		const char* name;
+		uint64_t timestamp;
+		uint64_t duration;
+		// 'X' for a complete zone, 'B'/'E' for separate begin and end
+		char type;
+	};
+
+	// Name strings given to zones and begin/end must outlive the profiling session
+	static bool start(const Path& path);
+	static void stop();
+	static bool is_running() { return _running.load(std::memory_order_relaxed); }
+
+	// Writes every event recorded so far; one thread at a time
+	static void flush();
+
+	// Labels the calling thread in the trace
+	static void set_thread_name(std::string name);
+
+	// Nanoseconds since the session started
+	static uint64_t now() {
+		return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()) -
+			   _epoch.load(std::memory_order_relaxed);
+	}
+
+	static void record(const Event& event);
+	static void begin(const char* name);
+	static void end();
+
+private:
+	static_assert(std::is_same_v<std::chrono::steady_clock::duration, std::chrono::nanoseconds>);
+
+	static inline std::atomic<bool> _running { false };
+	static inline std::atomic<uint64_t> _epoch { 0 };
+};
+
+class ProfileZone {
+	const char* _name;
+	uint64_t _start;
+
+public:
+	explicit ProfileZone(const char* name) :
+			_name(Profiler::is_running() ? name : nullptr), _start(_name ? Profiler::now() : 0) {}
+	~ProfileZone() {
+		if (_name)
+			Profiler::record({ .name = _name, .timestamp = _start, .duration = Profiler::now() - _start, .type = 'X' });
+	}
+
+	ProfileZone(const ProfileZone&) = delete;
+	ProfileZone& operator=(const ProfileZone&) = delete;
+};
+
+} // namespace feather
+
+#if FEATHER_PROFILER
+// Times the rest of the enclosing scope; name must be a string literal (or otherwise outlive the session)
+#define FPROFILE_ZONE(name) const ::feather::ProfileZone CONCAT(_profile_zone_, __LINE__)(name)
+#define FPROFILE_FUNCTION() FPROFILE_ZONE(__func__)
+#else
+#define FPROFILE_ZONE(name) static_assert(true)
+#define FPROFILE_FUNCTION() static_assert(true)
+#endif
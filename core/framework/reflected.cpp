@@ -8,4 +8,8 @@ namespace feather {
 void Reflected::_bind_members() {
 }
 
+const ClassInfo* Reflected::get_class_info_static() {
+	return ClassDB::get_class_info<Reflected>();
+}
+
 } //namespace feather
\ No newline at end of file
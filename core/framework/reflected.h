@@ -4,6 +4,9 @@
 #include "static_string.hpp"
 
 namespace feather {
+
+struct ClassInfo;
+
 // base class for reflected objects
 class Reflected {
 	friend class ClassDB;
@@ -21,9 +24,12 @@ class Reflected {
 	constexpr static StaticString get_parent_name() { return ""_ss; }
 	inline virtual bool is_of_type(StaticString type_name) const { return get_class_static() == type_name; }
 	inline virtual StaticString get_class_name() = 0;
+	// Null until the class is registered with ClassDB
+	static const ClassInfo* get_class_info_static();
+	virtual const ClassInfo* get_class_info() const { return get_class_info_static(); }
 	template <is_reflected_class_type T>
 	bool is_of_type() const {
-		return is_of_type(T::get_class_static());
+		return object_cast<const T>(this) != nullptr;
 	}
 };
 } //namespace feather
\ No newline at end of file
@@ -27,6 +27,13 @@ T* object_cast(T2* object) {
 	if (object == nullptr) {
 		return nullptr;
 	}
+	// Both classes registered: a class-ID range compare (see ClassInfo::is_a)
+	// instead of a virtual name compare per level of the hierarchy
+	const auto* info = object->get_class_info();
+	const auto* base_info = std::remove_const_t<T>::get_class_info_static();
+	if (info && base_info) {
+		return info->is_a(*base_info) ? static_cast<T*>(object) : nullptr;
+	}
 	if (object->is_of_type(std::remove_const_t<T>::get_class_static())) {
 		return static_cast<T*>(object);
 	}
@@ -0,0 +1,331 @@
+#pragma once
+
+#include "assert.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <stop_token>
+#include <utility>
+
+namespace feather {
+
+namespace ring_queue_detail {
+
+// Lets the consumer block in wait_pop without costing producers more than a
+// fence and a load while nobody waits
+class Signal {
+	alignas(64) std::atomic<uint32_t> _generation { 0 };
+	// Set by the (single) consumer before it parks. The first producer to see it
+	// clears it, so the pushes that follow before the consumer runs again don't
+	// each pay for a wake.
+	std::atomic<bool> _waiting { false };
+
+public:
+	// Producers, after publishing
+	void notify() noexcept {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (_waiting.load(std::memory_order_relaxed) && _waiting.exchange(false, std::memory_order_relaxed)) {
+			_generation.fetch_add(1, std::memory_order_release);
+			_generation.notify_all();
+		}
+	}
+
+	// Consumer: blocks until is_ready() or a stop request. The fence pairs with
+	// the one in notify(): either the producer sees the waiter, or the waiter
+	// sees the element.
+	template <class F>
+	void wait(F&& is_ready, const std::stop_token& stop) noexcept {
+		const uint32_t generation = _generation.load(std::memory_order_acquire);
+		_waiting.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (!is_ready() && !stop.stop_requested())
+			_generation.wait(generation, std::memory_order_acquire);
+		_waiting.store(false, std::memory_order_relaxed);
+	}
+
+	void wake() noexcept {
+		_generation.fetch_add(1, std::memory_order_release);
+		_generation.notify_all();
+	}
+};
+
+// Raw slot storage, so elements only exist while queued
+template <class T>
+struct Storage {
+	struct Cell {
+		alignas(T) std::byte bytes[sizeof(T)];
+	};
+	std::unique_ptr<Cell[]> cells;
+
+	explicit Storage(size_t capacity) : cells(new Cell[capacity]) {}
+
+	T* get(size_t i) noexcept { return std::launder(reinterpret_cast<T*>(cells[i].bytes)); }
+};
+
+} // namespace ring_queue_detail
+
+// Bounded single-producer single-consumer queue. Each side owns its index on
+// its own cache line and keeps a cached copy of the other's, so it only
+// touches the shared line when the cached one says full (or empty).
+//
+// Capacity must be a power of two. Pushes fail rather than block when full.
+template <class T>
+class SpscQueue {
+	const size_t _mask;
+	ring_queue_detail::Storage<T> _storage;
+
+	alignas(64) std::atomic<size_t> _head { 0 };
+	size_t _cached_tail = 0;
+
+	alignas(64) std::atomic<size_t> _tail { 0 };
+	size_t _cached_head = 0;
+
+	ring_queue_detail::Signal _signal;
+
+	// Consumer only
+	[[nodiscard]] size_t _readable() noexcept {
+		const size_t head = _head.load(std::memory_order_relaxed);
+		if (_cached_tail == head)
+			_cached_tail = _tail.load(std::memory_order_acquire);
+		return _cached_tail - head;
+	}
+
+	// Producer only
+	[[nodiscard]] size_t _writable() noexcept {
+		const size_t tail = _tail.load(std::memory_order_relaxed);
+		if (tail - _cached_head > _mask)
+			_cached_head = _head.load(std::memory_order_acquire);
+		return _mask + 1 - (tail - _cached_head);
+	}
+
+public:
+	explicit SpscQueue(size_t capacity) : _mask(capacity - 1), _storage(capacity) {
+		fassert(std::has_single_bit(capacity), "SpscQueue capacity must be a power of two");
+	}
+
+	~SpscQueue() {
+		for (size_t i = _head.load(std::memory_order_relaxed); i != _tail.load(std::memory_order_relaxed); ++i) {
+			std::destroy_at(_storage.get(i & _mask));
+		}
+	}
+
+	SpscQueue(const SpscQueue&) = delete;
+	SpscQueue& operator=(const SpscQueue&) = delete;
+
+	[[nodiscard]] size_t capacity() const noexcept { return _mask + 1; }
+
+	// With notify false, the push skips waking wait_pop (and the fence that
+	// costs): for queues whose consumer only ever polls
+	template <bool notify = true, class U>
+	bool try_push(U&& item) {
+		if (_writable() == 0)
+			return false;
+		const size_t tail = _tail.load(std::memory_order_relaxed);
+		std::construct_at(_storage.get(tail & _mask), std::forward<U>(item));
+		_tail.store(tail + 1, std::memory_order_release);
+		if constexpr (notify)
+			_signal.notify();
+		return true;
+	}
+
+	// Moves as many items as fit, publishing them at once; returns how many
+	template <bool notify = true>
+	size_t try_push_batch(std::span<T> items) {
+		const size_t count = std::min(items.size(), _writable());
+		const size_t tail = _tail.load(std::memory_order_relaxed);
+		for (size_t i = 0; i < count; ++i) {
+			std::construct_at(_storage.get((tail + i) & _mask), std::move(items[i]));
+		}
+		if (count > 0) {
+			_tail.store(tail + count, std::memory_order_release);
+			if constexpr (notify)
+				_signal.notify();
+		}
+		return count;
+	}
+
+	bool try_pop(T& out) {
+		if (_readable() == 0)
+			return false;
+		const size_t head = _head.load(std::memory_order_relaxed);
+		T* slot = _storage.get(head & _mask);
+		out = std::move(*slot);
+		std::destroy_at(slot);
+		_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Pops up to out.size() items; returns how many
+	size_t try_pop_batch(std::span<T> out) {
+		const size_t count = std::min(out.size(), _readable());
+		const size_t head = _head.load(std::memory_order_relaxed);
+		for (size_t i = 0; i < count; ++i) {
+			T* slot = _storage.get((head + i) & _mask);
+			out[i] = std::move(*slot);
+			std::destroy_at(slot);
+		}
+		if (count > 0)
+			_head.store(head + count, std::memory_order_release);
+		return count;
+	}
+
+	// Blocks until an item arrives; false if stop is requested first
+	bool wait_pop(T& out, const std::stop_token& stop = {}) {
+		std::stop_callback wake_on_stop(stop, [this] { _signal.wake(); });
+		while (!try_pop(out)) {
+			if (stop.stop_requested())
+				return false;
+			_signal.wait([this] { return _tail.load(std::memory_order_acquire) != _head.load(std::memory_order_relaxed); },
+						 stop);
+		}
+		return true;
+	}
+};
+
+// Bounded multi-producer single-consumer queue (Vyukov's bounded queue with a
+// single consumer). Every slot carries a sequence number telling whether it's
+// free for the producer of a given lap or filled for the consumer, so
+// producers only contend on the tail index and never wait on each other.
+//
+// Capacity must be a power of two, at least 2. Pushes fail rather than block
+// when full.
+template <class T>
+class MpscQueue {
+	struct Slot {
+		std::atomic<size_t> sequence;
+	};
+
+	const size_t _mask;
+	std::unique_ptr<Slot[]> _slots;
+	ring_queue_detail::Storage<T> _storage;
+
+	alignas(64) std::atomic<size_t> _tail { 0 };
+	// Consumer only
+	alignas(64) size_t _head = 0;
+
+	ring_queue_detail::Signal _signal;
+
+	// Claims count slots starting at the returned position, or fails when fewer are free
+	bool _claim(size_t count, size_t& position) noexcept {
+		position = _tail.load(std::memory_order_relaxed);
+		while (true) {
+			// The consumer frees slots in order, so the last one being free means they all are
+			const size_t last = position + count - 1;
+			const size_t sequence = _slots[last & _mask].sequence.load(std::memory_order_acquire);
+			const intptr_t lag = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(last);
+			if (lag == 0) {
+				if (_tail.compare_exchange_weak(position, position + count, std::memory_order_relaxed))
+					return true;
+			}
+			else if (lag < 0) {
+				return false;
+			}
+			else {
+				position = _tail.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	void _publish(size_t position) noexcept {
+		_slots[position & _mask].sequence.store(position + 1, std::memory_order_release);
+	}
+
+public:
+	explicit MpscQueue(size_t capacity) :
+			_mask(capacity - 1), _slots(new Slot[capacity]), _storage(capacity) {
+		// With one slot, "filled for lap n" and "free for lap n + 1" would look alike
+		fassert(capacity >= 2 && std::has_single_bit(capacity), "MpscQueue capacity must be a power of two, at least 2");
+		for (size_t i = 0; i < capacity; ++i) {
+			_slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	~MpscQueue() {
+		for (; _slots[_head & _mask].sequence.load(std::memory_order_relaxed) == _head + 1; ++_head) {
+			std::destroy_at(_storage.get(_head & _mask));
+		}
+	}
+
+	MpscQueue(const MpscQueue&) = delete;
+	MpscQueue& operator=(const MpscQueue&) = delete;
+
+	[[nodiscard]] size_t capacity() const noexcept { return _mask + 1; }
+
+	// notify as in SpscQueue::try_push
+	template <bool notify = true, class U>
+	bool try_push(U&& item) {
+		size_t position;
+		if (!_claim(1, position))
+			return false;
+		std::construct_at(_storage.get(position & _mask), std::forward<U>(item));
+		_publish(position);
+		if constexpr (notify)
+			_signal.notify();
+		return true;
+	}
+
+	// All or nothing: the items stay contiguous in the queue
+	template <bool notify = true>
+	bool try_push_batch(std::span<T> items) {
+		if (items.empty())
+			return true;
+		if (items.size() > capacity())
+			return false;
+		size_t position;
+		if (!_claim(items.size(), position))
+			return false;
+		for (size_t i = 0; i < items.size(); ++i) {
+			std::construct_at(_storage.get((position + i) & _mask), std::move(items[i]));
+			_publish(position + i);
+		}
+		if constexpr (notify)
+			_signal.notify();
+		return true;
+	}
+
+	// Consumer only
+	bool try_pop(T& out) {
+		Slot& slot = _slots[_head & _mask];
+		if (slot.sequence.load(std::memory_order_acquire) != _head + 1)
+			return false;
+		T* item = _storage.get(_head & _mask);
+		out = std::move(*item);
+		std::destroy_at(item);
+		slot.sequence.store(_head + _mask + 1, std::memory_order_release);
+		++_head;
+		return true;
+	}
+
+	// Consumer only; stops at the first slot still being written
+	size_t try_pop_batch(std::span<T> out) {
+		size_t count = 0;
+		while (count < out.size() && try_pop(out[count])) {
+			++count;
+		}
+		return count;
+	}
+
+	// Consumer only. Blocks until an item arrives; false if stop is requested first
+	bool wait_pop(T& out, const std::stop_token& stop = {}) {
+		std::stop_callback wake_on_stop(stop, [this] { _signal.wake(); });
+		while (!try_pop(out)) {
+			if (stop.stop_requested())
+				return false;
+			_signal.wait(
+					[this] {
+						return _slots[_head & _mask].sequence.load(std::memory_order_acquire) == _head + 1;
+					},
+					stop
+			);
+		}
+		return true;
+	}
+};
+
+} // namespace feather
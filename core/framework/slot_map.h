@@ -0,0 +1,233 @@
+#pragma once
+
+#include "assert.h"
+
+#include <cstdint>
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace feather {
+
+// Generational slot map: O(1) add/remove/lookup through 32-bit handles that stay
+// valid for the element's lifetime, while the values themselves are kept packed
+// so iteration is a linear scan with no holes. Removal swaps the last value into
+// the vacated spot, so iteration order is NOT insertion order.
+//
+// A handle packs a slot index (low bits) with the slot's generation (high bits).
+// The generation is bumped every time a slot is freed, so a handle to a removed
+// element is detected as stale instead of aliasing whatever reused its slot.
+template <class T>
+class SlotMap {
+public:
+	using handle_t = uint32_t;
+
+	static constexpr uint32_t index_bits = 20;
+	static constexpr uint32_t generation_bits = 32 - index_bits;
+	static constexpr uint32_t max_slots = 1u << index_bits;
+	static constexpr handle_t invalid_handle = ~handle_t { 0 };
+
+private:
+	static constexpr uint32_t _index_mask = max_slots - 1;
+	static constexpr uint32_t _generation_mask = (1u << generation_bits) - 1;
+	static constexpr uint32_t _end_of_free_list = _index_mask;
+	// Slot index of a reserved handle: never below size(), so never live
+	static constexpr uint32_t _reserved_index = ~uint32_t { 0 };
+
+	struct Slot {
+		// Position of the value in _values while occupied, next free slot otherwise.
+		uint32_t index;
+		uint32_t generation;
+	};
+
+	std::vector<T> _values;
+	// _value_slots[i] is the slot owning _values[i], needed to patch the slot of
+	// the value moved by a swap-remove.
+	std::vector<uint32_t> _value_slots;
+	std::vector<Slot> _slots;
+	uint32_t _free_head = _end_of_free_list;
+
+	static constexpr uint32_t _slot_of(handle_t h) { return h & _index_mask; }
+	static constexpr uint32_t _generation_of(handle_t h) { return h >> index_bits; }
+	static constexpr handle_t _make_handle(uint32_t slot, uint32_t generation) {
+		return ((generation & _generation_mask) << index_bits) | slot;
+	}
+
+	bool _is_slot_live(uint32_t slot) const {
+		uint32_t index = _slots[slot].index;
+		return index < _value_slots.size() && _value_slots[index] == slot;
+	}
+
+	uint32_t _acquire_slot();
+	void _release_slot(uint32_t slot);
+
+public:
+	handle_t add(T&&);
+	handle_t add(const T&);
+	template <class... TArgs>
+	handle_t emplace(TArgs&&... args);
+	void remove(handle_t h);
+
+	// Hands out a handle now and stores its value later, e.g. while the packed
+	// storage must not move. has_value() is false until emplace_reserved().
+	handle_t reserve_handle();
+	template <class... TArgs>
+	void emplace_reserved(handle_t h, TArgs&&... args);
+	// Gives up a reserved handle that never got a value
+	void release_reserved(handle_t h);
+
+	size_t size() const { return _values.size(); }
+	bool empty() const { return _values.empty(); }
+	void clear();
+	void reserve(size_t size);
+	// Releases capacity left over after a burst of removals; handles are unaffected.
+	void shrink_to_fit();
+	bool has_value(handle_t h) const;
+
+	T& operator[](handle_t h) { return _values[_slots[_slot_of(h)].index]; }
+	const T& operator[](handle_t h) const { return _values[_slots[_slot_of(h)].index]; }
+	T& at(handle_t h);
+	const T& at(handle_t h) const;
+
+	// Packed storage, valid until the next add/remove
+	T* data() { return _values.data(); }
+	const T* data() const { return _values.data(); }
+
+	auto begin() { return _values.begin(); }
+	auto end() { return _values.end(); }
+	auto begin() const { return _values.begin(); }
+	auto end() const { return _values.end(); }
+};
+
+template <class T>
+uint32_t SlotMap<T>::_acquire_slot() {
+	if (_free_head != _end_of_free_list) {
+		uint32_t slot = _free_head;
+		_free_head = _slots[slot].index;
+		return slot;
+	}
+
+	fassert(_slots.size() < _end_of_free_list, "SlotMap is out of slots");
+	_slots.push_back({ .index = 0, .generation = 0 });
+	return static_cast<uint32_t>(_slots.size() - 1);
+}
+
+template <class T>
+void SlotMap<T>::_release_slot(uint32_t slot) {
+	Slot& s = _slots[slot];
+	s.generation = (s.generation + 1) & _generation_mask;
+	s.index = _free_head;
+	_free_head = slot;
+}
+
+template <class T>
+typename SlotMap<T>::handle_t SlotMap<T>::add(T&& element) {
+	return emplace(std::move(element));
+}
+
+template <class T>
+typename SlotMap<T>::handle_t SlotMap<T>::add(const T& element) {
+	return emplace(element);
+}
+
+template <class T>
+template <class... TArgs>
+typename SlotMap<T>::handle_t SlotMap<T>::emplace(TArgs&&... args) {
+	uint32_t slot = _acquire_slot();
+	_values.emplace_back(std::forward<TArgs>(args)...);
+	_value_slots.push_back(slot);
+	_slots[slot].index = static_cast<uint32_t>(_values.size() - 1);
+	return _make_handle(slot, _slots[slot].generation);
+}
+
+template <class T>
+typename SlotMap<T>::handle_t SlotMap<T>::reserve_handle() {
+	uint32_t slot = _acquire_slot();
+	_slots[slot].index = _reserved_index;
+	return _make_handle(slot, _slots[slot].generation);
+}
+
+template <class T>
+template <class... TArgs>
+void SlotMap<T>::emplace_reserved(handle_t h, TArgs&&... args) {
+	uint32_t slot = _slot_of(h);
+	fassert(slot < _slots.size() && _slots[slot].index == _reserved_index &&
+					_slots[slot].generation == _generation_of(h),
+			"Handle was not reserved");
+	_values.emplace_back(std::forward<TArgs>(args)...);
+	_value_slots.push_back(slot);
+	_slots[slot].index = static_cast<uint32_t>(_values.size() - 1);
+}
+
+template <class T>
+void SlotMap<T>::release_reserved(handle_t h) {
+	uint32_t slot = _slot_of(h);
+	fassert(slot < _slots.size() && _slots[slot].index == _reserved_index &&
+					_slots[slot].generation == _generation_of(h),
+			"Handle was not reserved");
+	_release_slot(slot);
+}
+
+template <class T>
+void SlotMap<T>::remove(handle_t h) {
+	if (!has_value(h))
+		throw std::out_of_range { "No element for that handle" };
+
+	uint32_t slot = _slot_of(h);
+	uint32_t index = _slots[slot].index;
+	uint32_t last = static_cast<uint32_t>(_values.size() - 1);
+
+	if (index != last) {
+		_values[index] = std::move(_values[last]);
+		_value_slots[index] = _value_slots[last];
+		_slots[_value_slots[index]].index = index;
+	}
+	_values.pop_back();
+	_value_slots.pop_back();
+
+	_release_slot(slot);
+}
+
+template <class T>
+void SlotMap<T>::clear() {
+	// Every live slot goes through _release_slot so outstanding handles go stale
+	for (uint32_t slot : _value_slots) {
+		_release_slot(slot);
+	}
+	_values.clear();
+	_value_slots.clear();
+}
+
+template <class T>
+void SlotMap<T>::reserve(size_t size) {
+	_values.reserve(size);
+	_value_slots.reserve(size);
+	_slots.reserve(size);
+}
+
+template <class T>
+void SlotMap<T>::shrink_to_fit() {
+	_values.shrink_to_fit();
+	_value_slots.shrink_to_fit();
+}
+
+template <class T>
+bool SlotMap<T>::has_value(handle_t h) const {
+	uint32_t slot = _slot_of(h);
+	return slot < _slots.size() && _slots[slot].generation == _generation_of(h) && _is_slot_live(slot);
+}
+
+template <class T>
+T& SlotMap<T>::at(handle_t h) {
+	fassert(has_value(h), "Stale or invalid SlotMap handle");
+	return (*this)[h];
+}
+
+template <class T>
+const T& SlotMap<T>::at(handle_t h) const {
+	fassert(has_value(h), "Stale or invalid SlotMap handle");
+	return (*this)[h];
+}
+
+} // namespace feather
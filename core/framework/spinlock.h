@@ -9,6 +9,9 @@
 #endif
 
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
 
 inline void Pause() {
 #if defined(_MSC_VER) || defined(__SSE2__)
@@ -46,4 +49,109 @@ struct spinlock {
 	}
 
 	void unlock() noexcept { lock_.store(false, std::memory_order_release); }
-};
\ No newline at end of file
+};
+
+// Counters of an adaptive_lock<true>. Updated relaxed, so only approximate
+// while the lock is in use.
+struct lock_contention_stats {
+	std::atomic<uint64_t> acquisitions { 0 };
+	// Acquisitions that found the lock taken
+	std::atomic<uint64_t> contended { 0 };
+	// Pause() calls spent waiting
+	std::atomic<uint64_t> spins { 0 };
+	std::atomic<uint64_t> parks { 0 };
+	std::atomic<uint64_t> park_nanoseconds { 0 };
+};
+
+// Lock for critical sections that are usually short but sometimes aren't.
+// A waiter spins with exponential backoff for a few microseconds, then parks
+// on the atomic (a futex on Linux, WaitOnAddress on Windows) until the owner
+// wakes it, instead of burning a core like spinlock does.
+//
+// With track_contention, the lock also counts acquisitions, spins and park time
+// (see get_stats()); without it, it is the size of a uint32_t.
+template <bool track_contention = false>
+struct adaptive_lock {
+	struct no_stats {};
+
+	// 0: free, 1: locked, 2: locked and a waiter may be parked
+	std::atomic<uint32_t> state_ = { 0 };
+	[[no_unique_address]] std::conditional_t<track_contention, lock_contention_stats, no_stats> stats_;
+
+	// Backoff rounds before parking; round n pauses 2^n times
+	static constexpr uint32_t spin_rounds = 7;
+
+	void lock() noexcept {
+		uint32_t expected = 0;
+		if (state_.compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+			_record(false, 0);
+			return;
+		}
+		_lock_contended();
+	}
+
+	bool try_lock() noexcept {
+		uint32_t expected = 0;
+		if (state_.load(std::memory_order_relaxed) != 0 ||
+			!state_.compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed))
+			return false;
+		_record(false, 0);
+		return true;
+	}
+
+	void unlock() noexcept {
+		if (state_.exchange(0, std::memory_order_release) == 2)
+			state_.notify_one();
+	}
+
+	const lock_contention_stats& get_stats() const
+		requires track_contention
+	{
+		return stats_;
+	}
+
+	void _lock_contended() noexcept {
+		uint64_t spins = 0;
+		for (uint32_t round = 0, pauses = 1; round < spin_rounds; ++round, pauses *= 2) {
+			for (uint32_t i = 0; i < pauses; ++i) {
+				Pause();
+			}
+			spins += pauses;
+
+			uint32_t expected = 0;
+			if (state_.load(std::memory_order_relaxed) == 0 &&
+				state_.compare_exchange_weak(expected, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+				_record(true, spins);
+				return;
+			}
+		}
+
+		// Marking the lock 2 makes the owner wake someone on unlock. A waiter that
+		// gets it this way keeps the 2, since others may still be parked.
+		std::chrono::steady_clock::time_point park_start;
+		if constexpr (track_contention) {
+			stats_.parks.fetch_add(1, std::memory_order_relaxed);
+			park_start = std::chrono::steady_clock::now();
+		}
+		while (state_.exchange(2, std::memory_order_acquire) != 0) {
+			state_.wait(2, std::memory_order_relaxed);
+		}
+		if constexpr (track_contention) {
+			const auto parked = std::chrono::steady_clock::now() - park_start;
+			stats_.park_nanoseconds.fetch_add(
+					std::chrono::duration_cast<std::chrono::nanoseconds>(parked).count(), std::memory_order_relaxed
+			);
+		}
+		_record(true, spins);
+	}
+
+	void _record(bool contended, uint64_t spins) noexcept {
+		if constexpr (track_contention) {
+			stats_.acquisitions.fetch_add(1, std::memory_order_relaxed);
+			if (contended) {
+				stats_.contended.fetch_add(1, std::memory_order_relaxed);
+				stats_.spins.fetch_add(spins, std::memory_order_relaxed);
+			}
+		}
+	}
+};
@@ -4,21 +4,44 @@
 
 #include <cstdint>
 
-#include <deque>
+#include <bit>
 #include <optional>
+#include <stdexcept>
 #include <vector>
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 namespace feather {
 // The elements of this class will stay at the same index in the container during their existence
+//
+// Occupancy is mirrored in a bitmap (one bit per slot, 64 slots per word) so iteration
+// costs O(live + capacity / 64) instead of testing every std::optional, and add() finds
+// the lowest free slot without keeping a sorted free list.
+//
+// Indices are reused as soon as a slot frees up and nothing tells a stale one
+// apart; for churning ids that must catch stale handles, or hole-free
+// iteration, use SlotMap.
 template <class T>
 class StaticIndexedArray {
+	static constexpr size_t _word_bits = 64;
+
 	std::vector<std::optional<T>> _elements;
-	std::deque<size_t> _free_list;
+	std::vector<uint64_t> _occupancy;
+	size_t _size = 0;
+	// No free slot exists in the words before this one
+	size_t _first_free_word = 0;
 
 	bool _is_free(size_t i) const;
 	bool _is_index_valid(size_t i) const;
+	void _set_occupied(size_t i, bool occupied);
 	void _clean_free_slots();
-	size_t _get_first_element_index() const;
+	size_t _find_free_index();
+	size_t _next_occupied(size_t from) const;
+	size_t _prev_occupied(size_t from) const;
+
+	static size_t _skip_empty_words(const uint64_t* words, size_t word, size_t word_count);
 
 public:
 	size_t add(T&&);
@@ -28,6 +51,8 @@ class StaticIndexedArray {
 	bool empty() const;
 	void clear();
 	void reserve(size_t size);
+	// Drops trailing empty slots and releases unused capacity; indices of live elements are unchanged.
+	void compact();
 	template <class... TArgs>
 	size_t emplace(TArgs... args);
 	bool has_value(size_t i) const { return _is_index_valid(i); }
@@ -37,9 +62,9 @@ class StaticIndexedArray {
 	T& at(int i);
 
 	class Iterator {
-		using VecIt = std::optional<T>*;
-		VecIt it, lowerBound, upperBound, first;
-		Iterator(VecIt it, VecIt lowerBound, VecIt upperBound, VecIt first);
+		StaticIndexedArray* array;
+		size_t it;
+		Iterator(StaticIndexedArray* array, size_t it);
 
 	public:
 		T& operator*();
@@ -48,19 +73,19 @@ class StaticIndexedArray {
 		Iterator operator--();
 		Iterator operator--(int);
 
-		size_t AbsoluteIndex() { return static_cast<size_t>(std::distance(first, it)); }
+		size_t AbsoluteIndex() { return it; }
 
 		friend bool operator==(const Iterator& a, const Iterator& b) { return a.it == b.it; }
 
-		T* operator->() { return &**it; }
+		T* operator->() { return &*array->_elements[it]; }
 
 		friend StaticIndexedArray;
 	};
 
 	class ConstIterator {
-		using VecIt = const std::optional<T>*;
-		VecIt it, lowerBound, upperBound, first;
-		ConstIterator(VecIt it, VecIt lowerBound, VecIt upperBound, VecIt first);
+		const StaticIndexedArray* array;
+		size_t it;
+		ConstIterator(const StaticIndexedArray* array, size_t it);
 
 	public:
 		const T& operator*() const;
@@ -71,9 +96,9 @@ class StaticIndexedArray {
 
 		friend bool operator==(const ConstIterator& a, const ConstIterator& b) { return a.it == b.it; }
 
-		T* operator->() { return &**it; }
+		const T* operator->() { return &*array->_elements[it]; }
 
-		std::uint32_t absolute_index() { return std::distance(first, it); }
+		std::uint32_t absolute_index() { return static_cast<std::uint32_t>(it); }
 
 		friend StaticIndexedArray;
 	};
@@ -86,7 +111,7 @@ class StaticIndexedArray {
 
 template <class T>
 bool StaticIndexedArray<T>::_is_free(size_t i) const {
-	return !_elements[i].has_value();
+	return !(_occupancy[i / _word_bits] & (uint64_t { 1 } << (i % _word_bits)));
 }
 
 template <class T>
@@ -94,53 +119,111 @@ bool StaticIndexedArray<T>::_is_index_valid(size_t i) const {
 	return i < _elements.size() && !_is_free(i);
 }
 
+template <class T>
+void StaticIndexedArray<T>::_set_occupied(size_t i, bool occupied) {
+	const size_t word = i / _word_bits;
+	const uint64_t bit = uint64_t { 1 } << (i % _word_bits);
+	if (occupied) {
+		_occupancy[word] |= bit;
+	}
+	else {
+		_occupancy[word] &= ~bit;
+		_first_free_word = std::min(_first_free_word, word);
+	}
+}
+
 template <class T>
 void StaticIndexedArray<T>::_clean_free_slots() {
-	auto rIt = _elements.rbegin();
-	while (rIt != _elements.rend() && !rIt->has_value())
-		++rIt;
+	size_t new_size = _size == 0 ? 0 : _prev_occupied(_elements.size()) + 1;
+
+	_elements.resize(new_size);
+	_occupancy.resize((new_size + _word_bits - 1) / _word_bits);
+	_first_free_word = std::min(_first_free_word, _occupancy.size());
+}
 
-	size_t nbItemsToRemove = std::distance(_elements.rbegin(), rIt);
+// Lowest free slot, growing the storage when every slot is taken
+template <class T>
+size_t StaticIndexedArray<T>::_find_free_index() {
+	while (_first_free_word < _occupancy.size()) {
+		const uint64_t free_bits = ~_occupancy[_first_free_word];
+		if (free_bits) {
+			size_t index = _first_free_word * _word_bits + std::countr_zero(free_bits);
+			if (index < _elements.size())
+				return index;
+			break; // Only the unused tail of the last word is left
+		}
+		++_first_free_word;
+	}
 
-	_free_list.resize(_free_list.size() - nbItemsToRemove);
-	_elements.resize(_elements.size() - nbItemsToRemove);
+	_elements.emplace_back();
+	if (_elements.size() > _occupancy.size() * _word_bits)
+		_occupancy.push_back(0);
+	return _elements.size() - 1;
 }
 
+// Index of the first word at or after `word` with any bit set, or word_count
 template <class T>
-size_t StaticIndexedArray<T>::_get_first_element_index() const {
-	int current = 0;
-	while (!_free_list.empty() && current < _free_list.size() && _free_list[current] == current)
-		current++;
-	return current;
+size_t StaticIndexedArray<T>::_skip_empty_words(const uint64_t* words, size_t word, size_t word_count) {
+#ifdef __AVX2__
+	// Test 256 slots per instruction while walking over long empty runs
+	while (word + 4 <= word_count) {
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + word));
+		if (!_mm256_testz_si256(block, block))
+			break;
+		word += 4;
+	}
+#endif
+	while (word < word_count && words[word] == 0)
+		++word;
+	return word;
 }
 
+// First occupied index >= from, or _elements.size()
 template <class T>
-size_t StaticIndexedArray<T>::add(T&& element) {
-	size_t index;
-	if (_free_list.empty()) {
-		_elements.push_back(std::move(element));
-		index = _elements.size() - 1;
+size_t StaticIndexedArray<T>::_next_occupied(size_t from) const {
+	if (from >= _elements.size())
+		return _elements.size();
+
+	size_t word = from / _word_bits;
+	uint64_t bits = _occupancy[word] & (~uint64_t { 0 } << (from % _word_bits));
+	if (!bits) {
+		word = _skip_empty_words(_occupancy.data(), word + 1, _occupancy.size());
+		if (word == _occupancy.size())
+			return _elements.size();
+		bits = _occupancy[word];
 	}
-	else {
-		index = _free_list.front();
-		_elements[index] = std::move(element);
-		_free_list.pop_front();
+	return word * _word_bits + std::countr_zero(bits);
+}
+
+// Last occupied index < from, or _elements.size() when there is none
+template <class T>
+size_t StaticIndexedArray<T>::_prev_occupied(size_t from) const {
+	size_t word = from / _word_bits;
+	size_t bit = from % _word_bits;
+	uint64_t bits = (word < _occupancy.size() && bit) ? _occupancy[word] & (~uint64_t { 0 } >> (_word_bits - bit)) : 0;
+	while (!bits) {
+		if (word == 0)
+			return _elements.size();
+		bits = _occupancy[--word];
 	}
+	return word * _word_bits + (_word_bits - 1 - std::countl_zero(bits));
+}
+
+template <class T>
+size_t StaticIndexedArray<T>::add(T&& element) {
+	size_t index = _find_free_index();
+	_elements[index] = std::move(element);
+	_set_occupied(index, true);
+	++_size;
 	return index;
 }
 
 template <class T>
 size_t StaticIndexedArray<T>::add(const T& element) {
-	size_t index;
-	if (_free_list.empty()) {
-		_elements.push_back(element);
-		index = _elements.size() - 1;
-	}
-	else {
-		index = _free_list.front();
-		_elements[index] = element;
-		_free_list.pop_front();
-	}
+	size_t index = _find_free_index();
+	_elements[index] = element;
+	_set_occupied(index, true);
+	++_size;
 	return index;
 }
 
@@ -150,7 +233,8 @@ void StaticIndexedArray<T>::remove(size_t i) {
 		throw std::out_of_range { "No element at that index" };
 
 	_elements[i] = {};
-	_free_list.insert(std::lower_bound(_free_list.begin(), _free_list.end(), i), i);
+	_set_occupied(i, false);
+	--_size;
 
 	if (i == _elements.size() - 1) {
 		_clean_free_slots();
@@ -159,7 +243,7 @@ void StaticIndexedArray<T>::remove(size_t i) {
 
 template <class T>
 size_t StaticIndexedArray<T>::size() const {
-	return _elements.size() - _free_list.size();
+	return _size;
 }
 
 template <class T>
@@ -170,12 +254,22 @@ bool StaticIndexedArray<T>::empty() const {
 template <class T>
 void StaticIndexedArray<T>::clear() {
 	_elements.clear();
-	_free_list.clear();
+	_occupancy.clear();
+	_size = 0;
+	_first_free_word = 0;
 }
 
 template <class T>
 void StaticIndexedArray<T>::reserve(size_t size) {
 	_elements.reserve(size);
+	_occupancy.reserve((size + _word_bits - 1) / _word_bits);
+}
+
+template <class T>
+void StaticIndexedArray<T>::compact() {
+	_clean_free_slots();
+	_elements.shrink_to_fit();
+	_occupancy.shrink_to_fit();
 }
 
 template <class T>
@@ -191,145 +285,106 @@ T& StaticIndexedArray<T>::operator[](size_t i) {
 
 template <class T>
 const T& StaticIndexedArray<T>::at(size_t i) const {
-	fassert(!_is_index_valid(i));
+	fassert(_is_index_valid(i));
 	return *_elements[i];
 }
 
 template <class T>
 T& StaticIndexedArray<T>::at(int i) {
-	fassert(!_is_index_valid(i));
+	fassert(_is_index_valid(i));
 	return *_elements[i];
 }
 
 template <class T>
-StaticIndexedArray<T>::Iterator::Iterator(VecIt it, VecIt lowerBound, VecIt upperBound, VecIt first)
-		: it { it }
-		, lowerBound { lowerBound }
-		, upperBound { upperBound }
-		, first { first } {
+StaticIndexedArray<T>::Iterator::Iterator(StaticIndexedArray* array, size_t it) : array { array }, it { it } {
 }
 
 template <class T>
-StaticIndexedArray<T>::ConstIterator::ConstIterator(VecIt it, VecIt lowerBound, VecIt upperBound, VecIt first)
-		: it { it }
-		, lowerBound { lowerBound }
-		, upperBound { upperBound }
-		, first { first } {
+StaticIndexedArray<T>::ConstIterator::ConstIterator(const StaticIndexedArray* array, size_t it)
+		: array { array }
+		, it { it } {
 }
 
 template <class T>
 T& StaticIndexedArray<T>::Iterator::operator*() {
-	return **it;
+	return *array->_elements[it];
 }
 
 template <class T>
 typename StaticIndexedArray<T>::Iterator StaticIndexedArray<T>::Iterator::operator++() {
-	do
-		++it;
-	while (it != upperBound && !it->has_value());
+	it = array->_next_occupied(it + 1);
 	return *this;
 }
 
 template <class T>
 typename StaticIndexedArray<T>::Iterator StaticIndexedArray<T>::Iterator::operator++(int) {
 	auto prev = *this;
-	do
-		++it;
-	while (it != upperBound && !it->has_value());
+	++*this;
 	return prev;
 }
 
 template <class T>
 typename StaticIndexedArray<T>::Iterator StaticIndexedArray<T>::Iterator::operator--() {
-	do
-		--it;
-	while (it != lowerBound && !it->has_value());
+	it = array->_prev_occupied(it);
 	return *this;
 }
 
 template <class T>
 typename StaticIndexedArray<T>::Iterator StaticIndexedArray<T>::Iterator::operator--(int) {
 	auto prev = *this;
-	do
-		--it;
-	while (it != lowerBound && !it->has_value());
+	--*this;
 	return prev;
 }
 
 template <class T>
 const T& StaticIndexedArray<T>::ConstIterator::operator*() const {
-	return **it;
+	return *array->_elements[it];
 }
 
 template <class T>
 typename StaticIndexedArray<T>::ConstIterator StaticIndexedArray<T>::ConstIterator::operator++() {
-	do
-		++it;
-	while (it != upperBound && !it->has_value());
+	it = array->_next_occupied(it + 1);
 	return *this;
 }
 
 template <class T>
 typename StaticIndexedArray<T>::ConstIterator StaticIndexedArray<T>::ConstIterator::operator++(int) {
 	auto prev = *this;
-	do
-		++it;
-	while (it != upperBound && !it->has_value());
+	++*this;
 	return prev;
 }
 
 template <class T>
 typename StaticIndexedArray<T>::ConstIterator StaticIndexedArray<T>::ConstIterator::operator--() {
-	do
-		--it;
-	while (it != lowerBound && !it->has_value());
+	it = array->_prev_occupied(it);
 	return *this;
 }
 
 template <class T>
 typename StaticIndexedArray<T>::ConstIterator StaticIndexedArray<T>::ConstIterator::operator--(int) {
 	auto prev = *this;
-	do
-		--it;
-	while (it != lowerBound && !it->has_value());
+	--*this;
 	return prev;
 }
 
 template <class T>
 typename StaticIndexedArray<T>::Iterator StaticIndexedArray<T>::begin() {
-	int current = 0;
-	while (!_free_list.empty() && current < _free_list.size() && _free_list[current] == current)
-		current++;
-
-	return Iterator { _elements.data() + current,
-					  _elements.data() + current - 1,
-					  _elements.data() + std::max(_elements.size() - 1ULL, 0ULL) + 1,
-					  _elements.data() };
+	return Iterator { this, _next_occupied(0) };
 }
 
 template <class T>
 typename StaticIndexedArray<T>::Iterator StaticIndexedArray<T>::end() {
-	auto it = _elements.data() + std::max(_elements.size() - 1ULL, 0ULL) + 1;
-	return Iterator { it, begin().lowerBound, it, _elements.data() };
+	return Iterator { this, _elements.size() };
 }
 
 template <class T>
 typename StaticIndexedArray<T>::ConstIterator StaticIndexedArray<T>::begin() const {
-	int current = 0;
-	while (!_free_list.empty() && current < _free_list.size() && _free_list[current] == current)
-		current++;
-
-	return ConstIterator { _elements.data() + current,
-						   _elements.data() + current - 1,
-						   _elements.data() + std::max(_elements.size() - 1, 0ULL) + 1,
-						   _elements.data() };
+	return ConstIterator { this, _next_occupied(0) };
 }
 
 template <class T>
 typename StaticIndexedArray<T>::ConstIterator StaticIndexedArray<T>::end() const {
-	const auto beforeBegin = _elements.data() + _get_first_element_index();
-	const auto* endPtr = _elements.data() + std::max(_elements.size() - 1, 0ULL) + 1;
-	return ConstIterator { endPtr, beforeBegin - 1, endPtr, _elements.begin() };
+	return ConstIterator { this, _elements.size() };
 }
 
 } // namespace feather
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "static_string.hpp"
+
+#include "alloc_tracker.h"
+#include "assert.h"
+
+#include <cstring>
+#include <memory_resource>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define FEATHER_CRC32_SSE42
+#include <nmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__ARM_FEATURE_CRC32) || defined(_M_ARM64)
+#define FEATHER_CRC32_ARM
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <arm_acle.h>
+#endif
+#endif
+
+namespace nassimp {
+
+namespace {
+
+uint32_t crc32_table(uint32_t crc, const char* data, size_t size) {
+	for (; size; ++data, --size)
+		crc = (crc >> 8) ^ crc_table[(crc ^ *data) & 0xff];
+	return crc;
+}
+
+#ifdef FEATHER_CRC32_SSE42
+// Not every x86-64 build targets SSE4.2, so the instruction is enabled for this
+// function only and picked at runtime
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("sse4.2")))
+#endif
+uint32_t crc32_hardware(uint32_t crc, const char* data, size_t size) {
+	uint64_t crc64 = crc;
+	for (; size >= 8; data += 8, size -= 8) {
+		uint64_t chunk;
+		std::memcpy(&chunk, data, sizeof(chunk));
+		crc64 = _mm_crc32_u64(crc64, chunk);
+	}
+	crc = static_cast<uint32_t>(crc64);
+	for (; size; ++data, --size)
+		crc = _mm_crc32_u8(crc, static_cast<uint8_t>(*data));
+	return crc;
+}
+
+bool has_hardware_crc32() {
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	return info[2] & (1 << 20);
+#else
+	return __builtin_cpu_supports("sse4.2");
+#endif
+}
+#elif defined(FEATHER_CRC32_ARM)
+uint32_t crc32_hardware(uint32_t crc, const char* data, size_t size) {
+	for (; size >= 8; data += 8, size -= 8) {
+		uint64_t chunk;
+		std::memcpy(&chunk, data, sizeof(chunk));
+		crc = __crc32cd(crc, chunk);
+	}
+	for (; size; ++data, --size)
+		crc = __crc32cb(crc, static_cast<uint8_t>(*data));
+	return crc;
+}
+
+// Only defined when the target guarantees the CRC extension
+bool has_hardware_crc32() {
+	return true;
+}
+#endif
+
+struct InternTable {
+	std::shared_mutex mutex;
+	std::unordered_map<uint32_t, std::string_view> entries;
+	std::pmr::monotonic_buffer_resource storage;
+};
+
+// Never destroyed: interned views must stay valid through static destruction
+InternTable& intern_table() {
+	static InternTable* table = [] {
+		feather::AllocTagScope tag { feather::AllocTag::permanent };
+		return new InternTable();
+	}();
+	return *table;
+}
+
+void check_collision(std::string_view interned, std::string_view str, uint32_t hash) {
+	// Only formatted on a collision: fassert takes its message by value
+	if (interned != str)
+		fassert(false,
+				std::format("StaticString hash collision: '{}' and '{}' both hash to {:#010x}", interned, str, hash));
+}
+
+} // namespace
+
+uint32_t crc32_runtime(std::string_view str) noexcept {
+#if defined(FEATHER_CRC32_SSE42) || defined(FEATHER_CRC32_ARM)
+	static const bool hardware = has_hardware_crc32();
+	if (hardware)
+		return crc32_hardware(0xffffffff, str.data(), str.size()) ^ 0xffffffff;
+#endif
+	return crc32_table(0xffffffff, str.data(), str.size()) ^ 0xffffffff;
+}
+
+StaticString StaticString::intern(std::string_view str) {
+	const uint32_t hash = crc32(str);
+	InternTable& table = intern_table();
+
+	{
+		std::shared_lock lock(table.mutex);
+		if (auto it = table.entries.find(hash); it != table.entries.end()) {
+			check_collision(it->second, str, hash);
+			return StaticString(it->second, hash);
+		}
+	}
+
+	std::unique_lock lock(table.mutex);
+	feather::AllocTagScope tag { feather::AllocTag::permanent };
+	auto [it, inserted] = table.entries.try_emplace(hash);
+	if (inserted) {
+		char* copy = static_cast<char*>(table.storage.allocate(str.size() + 1, alignof(char)));
+		std::memcpy(copy, str.data(), str.size());
+		copy[str.size()] = '\0';
+		it->second = std::string_view(copy, str.size());
+	}
+	else {
+		check_collision(it->second, str, hash);
+	}
+	return StaticString(it->second, hash);
+}
+
+} // namespace nassimp
@@ -0,0 +1,210 @@
+#pragma once
+
+#include "assert.h"
+#include "job_system.h"
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <thread>
+#include <utility>
+
+namespace feather {
+
+template <class T = void>
+class Task;
+
+namespace task_detail {
+
+// Continuation slot states besides a waiting coroutine's address
+inline void* const no_continuation = nullptr;
+inline void* const finished = reinterpret_cast<void*>(uintptr_t(1));
+
+class PromiseBase {
+	// The coroutine awaiting this one, or one of the states above. Atomic because
+	// a started task may finish on a worker while another thread awaits it.
+	std::atomic<void*> _continuation { no_continuation };
+	std::exception_ptr _exception;
+
+	template <class>
+	friend class feather::Task;
+
+public:
+	struct FinalAwaiter {
+		bool await_ready() const noexcept { return false; }
+
+		template <class Promise>
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+			void* continuation = handle.promise()._continuation.exchange(finished, std::memory_order_acq_rel);
+			if (continuation != no_continuation)
+				return std::coroutine_handle<>::from_address(continuation);
+			return std::noop_coroutine();
+		}
+
+		void await_resume() const noexcept {}
+	};
+
+	std::suspend_always initial_suspend() const noexcept { return {}; }
+	FinalAwaiter final_suspend() const noexcept { return {}; }
+	void unhandled_exception() noexcept { _exception = std::current_exception(); }
+
+	// Returns false when the task already finished, so the awaiter goes on
+	bool set_continuation(std::coroutine_handle<> continuation) noexcept {
+		void* expected = no_continuation;
+		return _continuation.compare_exchange_strong(
+				expected, continuation.address(), std::memory_order_acq_rel, std::memory_order_acquire
+		);
+	}
+
+	bool is_finished() const noexcept { return _continuation.load(std::memory_order_acquire) == finished; }
+
+	void rethrow_if_failed() const {
+		if (_exception)
+			std::rethrow_exception(_exception);
+	}
+};
+
+template <class T>
+class Promise : public PromiseBase {
+	std::optional<T> _value;
+
+public:
+	Task<T> get_return_object() noexcept;
+
+	template <class U>
+	void return_value(U&& value) {
+		_value.emplace(std::forward<U>(value));
+	}
+
+	T take_result() {
+		rethrow_if_failed();
+		return std::move(*_value);
+	}
+};
+
+template <>
+class Promise<void> : public PromiseBase {
+public:
+	Task<void> get_return_object() noexcept;
+	void return_void() const noexcept {}
+	void take_result() const { rethrow_if_failed(); }
+};
+
+} // namespace task_detail
+
+// Lazy coroutine returning a T. Nothing runs until the task is awaited or
+// started; it then runs on the current thread up to its first suspension, and
+// resumes wherever whatever it awaits completes (see resume_on, IoExecutor).
+// Awaiting a task transfers control to it directly and comes back once it's
+// done, without growing the stack.
+//
+// The Task owns the coroutine: it must not be destroyed while a started
+// coroutine is still running.
+template <class T>
+class [[nodiscard]] Task {
+public:
+	using promise_type = task_detail::Promise<T>;
+
+	Task() = default;
+	explicit Task(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+	Task(Task&& other) noexcept : _handle(std::exchange(other._handle, nullptr)), _started(other._started) {}
+	Task& operator=(Task&& other) noexcept {
+		if (this != &other) {
+			_destroy();
+			_handle = std::exchange(other._handle, nullptr);
+			_started = other._started;
+		}
+		return *this;
+	}
+	~Task() { _destroy(); }
+
+	[[nodiscard]] bool is_valid() const { return _handle != nullptr; }
+	[[nodiscard]] bool is_done() const { return _handle && _handle.promise().is_finished(); }
+
+	// Runs the coroutine up to its first suspension and lets it go on by
+	// itself, e.g. so a frame can poll is_done() instead of blocking
+	void start() {
+		if (!_started) {
+			_started = true;
+			_handle.resume();
+		}
+	}
+
+	// Only once is_done()
+	decltype(auto) get_result() { return _handle.promise().take_result(); }
+
+	auto operator co_await() && noexcept {
+		struct Awaiter {
+			Task& task;
+
+			bool await_ready() const noexcept { return task.is_done(); }
+
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+				if (!task._started) {
+					task._started = true;
+					task._handle.promise().set_continuation(awaiting);
+					return task._handle;
+				}
+				// Already running elsewhere: either it picks the continuation up when it
+				// finishes, or it finished in between and we go on right away
+				if (!task._handle.promise().set_continuation(awaiting))
+					return awaiting;
+				return std::noop_coroutine();
+			}
+
+			decltype(auto) await_resume() { return task._handle.promise().take_result(); }
+		};
+		return Awaiter { *this };
+	}
+
+private:
+	std::coroutine_handle<promise_type> _handle;
+	bool _started = false;
+
+	void _destroy() {
+		if (_handle) {
+			fassert(!_started || is_done(), "Task destroyed while its coroutine is running");
+			_handle.destroy();
+		}
+	}
+};
+
+template <class T>
+Task<T> task_detail::Promise<T>::get_return_object() noexcept {
+	return Task<T> { std::coroutine_handle<Promise>::from_promise(*this) };
+}
+
+inline Task<void> task_detail::Promise<void>::get_return_object() noexcept {
+	return Task<void> { std::coroutine_handle<Promise>::from_promise(*this) };
+}
+
+// co_await resume_on(jobs) moves the rest of the coroutine to a job worker
+inline auto resume_on(JobSystem& jobs) noexcept {
+	struct Awaiter {
+		JobSystem& jobs;
+
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(std::coroutine_handle<> handle) { jobs.post([handle] { handle.resume(); }); }
+		void await_resume() const noexcept {}
+	};
+	return Awaiter { jobs };
+}
+
+// Starts the task and blocks until it's done, running jobs meanwhile
+template <class T>
+decltype(auto) sync_wait(Task<T>& task) {
+	task.start();
+	if (JobSystem* jobs = JobSystem::get()) {
+		jobs->wait_until([&task] { return task.is_done(); });
+	}
+	else {
+		while (!task.is_done()) {
+			std::this_thread::yield();
+		}
+	}
+	return task.get_result();
+}
+
+} // namespace feather
@@ -15,27 +15,20 @@ bool Variant::operator==(const Variant& other) const {
 		return false;
 	}
 
-	// Use std::visit to compare the values
-	return std::visit(
-			[](const auto& lhs, const auto& rhs) -> bool {
-				using LhsType = std::decay_t<decltype(lhs)>;
-				using RhsType = std::decay_t<decltype(rhs)>;
-
-				// If types don't match at compile time, return false
-				if constexpr (!std::is_same_v<LhsType, RhsType>) {
-					return false;
-				}
-				// monostate (NIL) is always equal
-				else if constexpr (std::is_same_v<LhsType, std::monostate>) {
-					return true;
-				}
-				// For all other types, use their operator==
-				else {
-					return lhs == rhs;
-				}
-			},
-			_data,
-			other._data);
+	return _dispatch(_type, [this, &other](auto t) -> bool {
+		using T = typename decltype(t)::type;
+		// monostate (NIL) is always equal
+		if constexpr (std::is_same_v<T, std::monostate>) {
+			return true;
+		}
+		// For all other types, use their operator==
+		else if constexpr (_is_inline<T>) {
+			return _get<T>() == other._get<T>();
+		}
+		else {
+			return _box() == other._box() || _get<T>() == other._get<T>();
+		}
+	});
 }
 
 std::string Variant::to_string() const {
@@ -43,34 +36,44 @@ std::string Variant::to_string() const {
 	case VariantType::NIL:
 		return "nil";
 	case VariantType::BOOL:
-		return std::get<bool>(_data) ? "true" : "false";
+		return _get<bool>() ? "true" : "false";
 	case VariantType::INT:
-		return std::to_string(std::get<int>(_data));
+		return std::to_string(_get<int>());
 	case VariantType::FLOAT:
-		return std::to_string(std::get<real_t>(_data));
+		return std::to_string(_get<real_t>());
 	case VariantType::STRING:
-		return std::get<std::string>(_data);
+		return _get<std::string>();
 	case VariantType::VECTOR2: {
-		auto& v = std::get<Vector2>(_data);
+		auto v = _get<Vector2>();
 		return "(" + std::to_string(v.x) + ", " + std::to_string(v.y) + ")";
 	}
 	case VariantType::VECTOR3: {
-		auto& v = std::get<Vector3>(_data);
+		auto v = _get<Vector3>();
 		return "(" + std::to_string(v.x) + ", " + std::to_string(v.y) + ", " + std::to_string(v.z) + ")";
 	}
 	case VariantType::COLOR: {
-		auto& c = std::get<Color>(_data);
+		auto& c = _get<Color>();
 		return "rgba(" + std::to_string(c.r()) + ", " + std::to_string(c.g()) + ", " + std::to_string(c.b()) + ", " +
 				std::to_string(c.a()) + ")";
 	}
 	case VariantType::VERTEX:
 		return "[Vertex]"; // expand if Vertex gains a meaningful string form
 	case VariantType::PATH:
-		return std::get<Path>(_data).string(); // assumes Path has to_string()
+		return _get<Path>().string(); // assumes Path has to_string()
 	case VariantType::RID:
-		return "RID(" + std::to_string(std::get<RID>(_data).id) + ")"; // assumes RID has .id
+		return "RID(" + std::to_string(_get<RID>().id) + ")"; // assumes RID has .id
 	case VariantType::ARRAY:
 		return "[Array]";
+	case VariantType::PACKED_BYTE_ARRAY:
+		return "PackedByteArray(" + std::to_string(_get<PackedByteArray>().size()) + ")";
+	case VariantType::PACKED_INT32_ARRAY:
+		return "PackedInt32Array(" + std::to_string(_get<PackedInt32Array>().size()) + ")";
+	case VariantType::PACKED_FLOAT32_ARRAY:
+		return "PackedFloat32Array(" + std::to_string(_get<PackedFloat32Array>().size()) + ")";
+	case VariantType::PACKED_VECTOR3_ARRAY:
+		return "PackedVector3Array(" + std::to_string(_get<PackedVector3Array>().size()) + ")";
+	case VariantType::PACKED_VERTEX_ARRAY:
+		return "PackedVertexArray(" + std::to_string(_get<PackedVertexArray>().size()) + ")";
 	case VariantType::OBJECT:
 		return "[Object] : " + get_name();
 	case VariantType::INVALID:
@@ -83,56 +86,43 @@ std::string Variant::get_name() const {
 	if (_type != VariantType::OBJECT) {
 		return to_string();
 	}
-	if (!_object_info) {
+	const ClassInfo* info = _get_object_info();
+	if (!info) {
 		return "[Object: no class info]";
 	}
-	return _object_info->name;
+	return info->name;
 }
 
 Variant Variant::get(std::string_view key) const {
 	fassert(_type == VariantType::OBJECT, "Variant is not an object");
-	if (!_object_info) {
+	auto info = _get_object_info();
+	if (!info) {
 		return {};
 	}
-	auto info = _object_info;
-	while (info) {
-		for (auto& property : info->properties) {
-			if (property.name == key) {
-				// Script-facing access: only public getters are reachable.
-				if (property.getter_access != AccessLevel::Public || !property.getter) {
-					return {};
-				}
-				return property.getter(std::get<Reflected*>(_data));
-			}
-		}
-		info = ClassDB::_get_class_info_internal(info->parent);
+	const ClassInfo::Property* property = info->property_table.find(key);
+	// Script-facing access: only public getters are reachable.
+	if (!property || property->getter_access != AccessLevel::Public || !property->getter) {
+		return {};
 	}
-	return {}; // property not found
+	return property->getter(_get<Reflected*>());
 }
 
 Variant Variant::get_internal(std::string_view key) const {
 	fassert(_type == VariantType::OBJECT, "Variant is not an object");
-	if (!_object_info) {
+	auto info = _get_object_info();
+	if (!info) {
 		return {};
 	}
-	auto info = _object_info;
-	while (info) {
-		for (auto& property : info->properties) {
-			if (property.name == key) {
-				if (!property.getter) {
-					return {};
-				}
-				return property.getter(std::get<Reflected*>(_data));
-			}
-		}
-		info = ClassDB::_get_class_info_internal(info->parent);
+	const ClassInfo::Property* property = info->property_table.find(key);
+	if (!property || !property->getter) {
+		return {};
 	}
-	return {}; // property not found
+	return property->getter(_get<Reflected*>());
 }
 
 Variant Variant::call(std::string_view method_name) {
 	fassert(_type == VariantType::OBJECT, "Variant is not an object");
-	if (!_object_info) {
+	if (!_get_object_info()) {
 		return {};
 	}
 	Variant self = as<Reflected*>().value();
@@ -141,7 +131,7 @@ Variant Variant::call(std::string_view method_name) {
 
 Variant Variant::call_internal(std::string_view method_name) {
 	fassert(_type == VariantType::OBJECT, "Variant is not an object");
-	if (!_object_info) {
+	if (!_get_object_info()) {
 		return {};
 	}
 	Variant self = as<Reflected*>().value();
@@ -150,61 +140,55 @@ Variant Variant::call_internal(std::string_view method_name) {
 
 void Variant::set(std::string_view key, const Variant& value) {
 	fassert(_type == VariantType::OBJECT, "Variant is not an object");
-	auto info = _object_info;
-	while (info) {
-		for (auto& property : info->properties) {
-			if (property.name == key) {
-				// Script-facing access: only public setters are writable.
-				if (property.setter_access != AccessLevel::Public || !property.setter) {
-					return;
-				}
-				property.setter(std::get<Reflected*>(_data), value);
-				return;
-			}
-		}
-		info = ClassDB::_get_class_info_internal(info->parent);
+	auto info = _get_object_info();
+	if (!info) {
+		return;
+	}
+	const ClassInfo::Property* property = info->property_table.find(key);
+	// Script-facing access: only public setters are writable.
+	if (!property || property->setter_access != AccessLevel::Public || !property->setter) {
+		return;
 	}
+	property->setter(_get<Reflected*>(), value);
 }
 
 void Variant::set_internal(std::string_view key, const Variant& value) {
 	fassert(_type == VariantType::OBJECT, "Variant is not an object");
-	auto info = _object_info;
-	while (info) {
-		for (auto& property : info->properties) {
-			if (property.name == key) {
-				if (!property.setter) {
-					return;
-				}
-				property.setter(std::get<Reflected*>(_data), value);
-				return;
-			}
-		}
-		info = ClassDB::_get_class_info_internal(info->parent);
+	auto info = _get_object_info();
+	if (!info) {
+		return;
+	}
+	const ClassInfo::Property* property = info->property_table.find(key);
+	if (!property || !property->setter) {
+		return;
 	}
+	property->setter(_get<Reflected*>(), value);
 }
 
-void Variant::set_class_info(StaticString class_name) {
-	_object_info = ClassDB::get()->_get_class_info_internal(class_name);
+void Variant::_type_mismatch(VariantType expected) const {
+	fassert(false,
+			std::format("Variant conversion expected type {} and got {}",
+						std::to_underlying(expected),
+						std::to_underlying(_type)));
+	std::unreachable();
+}
+
+const ClassInfo* Variant::_get_object_info() const {
+	const Reflected* object = _get<Reflected*>();
+	return object ? object->get_class_info() : nullptr;
 }
 
 Variant Variant::_internal_call(std::string_view method_name, std::span<Variant> args, bool enforce_public) const {
-	auto info = _object_info;
-	while (info) {
-		for (auto& method : info->methods) {
-			if (method.name == method_name) {
-				// Script-facing calls (enforce_public) only reach public methods.
-				if (enforce_public && method.access != AccessLevel::Public) {
-					return {};
-				}
-				Callable& callable = method.callable;
-
-				return callable.call(args);
-			}
-		}
-		info = ClassDB::_get_class_info_internal(info->parent);
+	auto info = _get_object_info();
+	if (!info) {
+		return {};
 	}
-
-	return {};
+	const ClassInfo::Method* method = info->method_table.find(method_name);
+	// Script-facing calls (enforce_public) only reach public methods.
+	if (!method || (enforce_public && method->access != AccessLevel::Public)) {
+		return {};
+	}
+	return method->callable.call(args);
 }
 
-} //namespace feather
\ No newline at end of file
+} //namespace feather
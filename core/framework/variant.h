@@ -2,6 +2,7 @@
 
 #include "assert.h"
 #include "container_utils.h"
+#include "packed_arrays.h"
 #include "path.h"
 #include "variant_array.h"
 
@@ -10,9 +11,12 @@
 #include "resources/rid.h"
 #include <math/math_defs.h>
 
+#include <atomic>
+#include <cstring>
 #include <expected>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <variant>
 
 namespace feather {
@@ -32,6 +36,12 @@ enum class VariantType : uint8_t {
 	STRING,
 	ARRAY,
 	PATH,
+	// Packed arrays
+	PACKED_BYTE_ARRAY,
+	PACKED_INT32_ARRAY,
+	PACKED_FLOAT32_ARRAY,
+	PACKED_VECTOR3_ARRAY,
+	PACKED_VERTEX_ARRAY,
 	// Objects
 	OBJECT,
 	// Invalid
@@ -70,6 +80,12 @@ consteval VariantType get_variant_type() {
 	else if constexpr (std::is_same_v<T, std::string>) {
 		return VariantType::STRING;
 	}
+	// Packed arrays take precedence over the generic container -> ARRAY conversion
+	VARIANT_TYPE_OPTION(PackedByteArray, PACKED_BYTE_ARRAY)
+	VARIANT_TYPE_OPTION(PackedInt32Array, PACKED_INT32_ARRAY)
+	VARIANT_TYPE_OPTION(PackedFloat32Array, PACKED_FLOAT32_ARRAY)
+	VARIANT_TYPE_OPTION(PackedVector3Array, PACKED_VECTOR3_ARRAY)
+	VARIANT_TYPE_OPTION(PackedVertexArray, PACKED_VERTEX_ARRAY)
 	else if constexpr (std::is_same_v<T, VariantArray> || std::is_array_v<T> || is_contiguous_container<T>) {
 		return VariantType::ARRAY;
 	}
@@ -95,27 +111,153 @@ template <typename T>
 concept VariantCompatible = get_variant_type<T>() != VariantType::INVALID;
 
 struct ClassInfo;
-
+class Callable;
+
+// Tagged value, 16 bytes: trivially copyable payloads of up to 12 bytes (bool,
+// int, real_t, Vector2/3, RID, object pointer) are stored inline; anything larger
+// or non-trivial (string, path, arrays, color, vertex) lives in an immutable
+// refcounted box that copies share. Packed arrays are boxed CowVectors, so copying
+// one out of a Variant only bumps the buffer's refcount. Objects carry no class info -- it is looked up
+// from the object itself when a member is accessed.
 class Variant {
-	using InternalVariant = std::variant<std::monostate,
-										 bool,
-										 int,
-										 real_t,
-										 Vector2,
-										 Vector3,
-										 Vertex,
-										 Color,
-										 std::string,
-										 Path,
-										 VariantArray,
-										 RID,
-										 Reflected*>;
-
-	InternalVariant _data;
-	VariantType _type;
-	ClassInfo* _object_info = nullptr;
-
-	void set_class_info(StaticString class_name);
+	struct BoxBase {
+		std::atomic<uint32_t> ref_count { 1 };
+		void (*destroy)(BoxBase*) = nullptr;
+	};
+
+	template <class T>
+	struct Box : BoxBase {
+		T value;
+
+		template <class U>
+		explicit Box(U&& v) : value(std::forward<U>(v)) {
+			destroy = [](BoxBase* box) { delete static_cast<Box*>(box); };
+		}
+	};
+
+	static constexpr size_t _inline_capacity = 12;
+
+	template <class T>
+	static constexpr bool _is_inline = std::is_trivially_copyable_v<T> && sizeof(T) <= _inline_capacity;
+
+	// Calls f with std::type_identity of the C++ type stored for `type`
+	template <class F>
+	static constexpr decltype(auto) _dispatch(VariantType type, F&& f) {
+		switch (type) {
+		case VariantType::BOOL:
+			return f(std::type_identity<bool> {});
+		case VariantType::INT:
+			return f(std::type_identity<int> {});
+		case VariantType::FLOAT:
+			return f(std::type_identity<real_t> {});
+		case VariantType::VECTOR3:
+			return f(std::type_identity<Vector3> {});
+		case VariantType::VECTOR2:
+			return f(std::type_identity<Vector2> {});
+		case VariantType::VERTEX:
+			return f(std::type_identity<Vertex> {});
+		case VariantType::COLOR:
+			return f(std::type_identity<Color> {});
+		case VariantType::RID:
+			return f(std::type_identity<RID> {});
+		case VariantType::STRING:
+			return f(std::type_identity<std::string> {});
+		case VariantType::ARRAY:
+			return f(std::type_identity<VariantArray> {});
+		case VariantType::PATH:
+			return f(std::type_identity<Path> {});
+		case VariantType::PACKED_BYTE_ARRAY:
+			return f(std::type_identity<PackedByteArray> {});
+		case VariantType::PACKED_INT32_ARRAY:
+			return f(std::type_identity<PackedInt32Array> {});
+		case VariantType::PACKED_FLOAT32_ARRAY:
+			return f(std::type_identity<PackedFloat32Array> {});
+		case VariantType::PACKED_VECTOR3_ARRAY:
+			return f(std::type_identity<PackedVector3Array> {});
+		case VariantType::PACKED_VERTEX_ARRAY:
+			return f(std::type_identity<PackedVertexArray> {});
+		case VariantType::OBJECT:
+			return f(std::type_identity<Reflected*> {});
+		default:
+			return f(std::type_identity<std::monostate> {});
+		}
+	}
+
+	template <class T>
+	static constexpr bool _is_storage_type = [] {
+		for (uint8_t i = 0; i <= static_cast<uint8_t>(VariantType::INVALID); ++i) {
+			if (_dispatch(VariantType(i), [](auto t) { return std::is_same_v<typename decltype(t)::type, T>; }))
+				return true;
+		}
+		return false;
+	}();
+
+	// Pointers are memcpy'd in and out, so 4-byte alignment is enough and the tag
+	// packs right after the payload.
+	alignas(4) std::byte _storage[_inline_capacity] {};
+	VariantType _type = VariantType::NIL;
+
+	bool _is_boxed() const {
+		return _dispatch(_type, [](auto t) { return !_is_inline<typename decltype(t)::type>; });
+	}
+
+	BoxBase* _box() const {
+		BoxBase* box;
+		std::memcpy(&box, _storage, sizeof(box));
+		return box;
+	}
+
+	template <class T, class U>
+	void _store(U&& value) {
+		if constexpr (_is_inline<T>) {
+			const T stored(std::forward<U>(value));
+			std::memcpy(_storage, &stored, sizeof(T));
+		}
+		else {
+			BoxBase* box = new Box<T>(std::forward<U>(value));
+			std::memcpy(_storage, &box, sizeof(box));
+		}
+	}
+
+	// Inline payloads come back by value, boxed ones by reference into the box
+	template <class T>
+	decltype(auto) _get() const {
+		static_assert(_is_storage_type<T>, "Not a Variant storage type");
+		if constexpr (_is_inline<T>) {
+			T value;
+			std::memcpy(&value, _storage, sizeof(T));
+			return value;
+		}
+		else {
+			return static_cast<const T&>(static_cast<const Box<T>*>(_box())->value);
+		}
+	}
+
+	void _retain() const {
+		if (_is_boxed())
+			_box()->ref_count.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void _release() {
+		if (_is_boxed()) {
+			BoxBase* box = _box();
+			if (box->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				box->destroy(box);
+		}
+	}
+
+	// Conversion operators: checked, but without building a std::expected
+	template <class T>
+	decltype(auto) _get_checked() const {
+		if (get_variant_type<T>() != _type) [[unlikely]]
+			_type_mismatch(get_variant_type<T>());
+		return get_unchecked<T>();
+	}
+
+	[[noreturn]] void _type_mismatch(VariantType expected) const;
+
+	// Class of the held object, straight from its vtable (no name lookup)
+	const ClassInfo* _get_object_info() const;
 
 	// enforce_public denies non-Public methods; *_internal entry points pass false.
 	[[nodiscard]] Variant
@@ -123,12 +265,12 @@ class Variant {
 
 public:
 	// Default constructor - NIL
-	Variant() : _data(std::monostate {}), _type(VariantType::NIL) {}
+	Variant() = default;
 
 	Variant(Reflected& ref);
 
 	// String literal constructor
-	Variant(const char* str) : _data(std::string(str)), _type(VariantType::STRING) {}
+	Variant(const char* str) : _type(VariantType::STRING) { _store<std::string>(str); }
 
 	// Generic constructor with concept constraint
 	template <VariantCompatible T>
@@ -136,57 +278,69 @@ class Variant {
 		constexpr VariantType type = get_variant_type<T>();
 		_type = type;
 
-		if constexpr (type == VariantType::BOOL) {
-			_data = std::move(value);
-		}
-		else if constexpr (type == VariantType::INT) {
-			_data = static_cast<int>(value);
+		if constexpr (type == VariantType::INT) {
+			_store<int>(static_cast<int>(value));
 		}
 		else if constexpr (type == VariantType::FLOAT) {
-			_data = static_cast<real_t>(value);
-		}
-		else if constexpr (type == VariantType::VECTOR3) {
-			_data = std::move(value);
-		}
-		else if constexpr (type == VariantType::STRING) {
-			_data = std::move(value);
+			_store<real_t>(static_cast<real_t>(value));
 		}
 		else if constexpr (type == VariantType::ARRAY) {
 			if constexpr (std::is_same_v<T, VariantArray>)
-				_data = std::move(value);
+				_store<VariantArray>(std::move(value));
 			else {
-				_data = VariantArray { value.begin(), value.end() };
+				_store<VariantArray>(VariantArray { value.begin(), value.end() });
 			}
 		}
 		else if constexpr (type == VariantType::OBJECT) {
 			if constexpr (std::is_pointer_v<T>) {
-				_data = static_cast<Reflected*>(value);
-				set_class_info(value->get_class_name());
+				_store<Reflected*>(static_cast<Reflected*>(value));
 			}
 			else {
-				_data = static_cast<Reflected*>(&value);
-				set_class_info(value.get_class_name());
+				_store<Reflected*>(static_cast<Reflected*>(&value));
 			}
 		}
 		else if constexpr (type == VariantType::NIL) {
-			_data = std::monostate {};
+			_type = VariantType::NIL;
 		}
 		else if constexpr (type == VariantType::INVALID) {
 			static_assert(false, "Variant type is unrecognized");
 		}
 		// default case if assignment is 1:1
 		else {
-			_data = std::move(value);
+			_store<T>(std::move(value));
 		}
 	}
 
-	// Copy and move constructors
-	Variant(const Variant& other) = default;
-	Variant(Variant&& other) noexcept = default;
+	// Copies share boxed payloads
+	Variant(const Variant& other) noexcept : _type(other._type) {
+		std::memcpy(_storage, other._storage, sizeof(_storage));
+		_retain();
+	}
+	Variant(Variant&& other) noexcept : _type(std::exchange(other._type, VariantType::NIL)) {
+		std::memcpy(_storage, other._storage, sizeof(_storage));
+	}
+
+	~Variant() { _release(); }
 
 	// Assignment operators
-	Variant& operator=(const Variant& other) = default;
-	Variant& operator=(Variant&& other) noexcept = default;
+	Variant& operator=(const Variant& other) noexcept {
+		Variant copy(other);
+		swap(*this, copy);
+		return *this;
+	}
+	Variant& operator=(Variant&& other) noexcept {
+		Variant moved(std::move(other));
+		swap(*this, moved);
+		return *this;
+	}
+
+	friend void swap(Variant& a, Variant& b) noexcept {
+		std::byte storage[_inline_capacity];
+		std::memcpy(storage, a._storage, sizeof(storage));
+		std::memcpy(a._storage, b._storage, sizeof(storage));
+		std::memcpy(b._storage, storage, sizeof(storage));
+		std::swap(a._type, b._type);
+	}
 
 	// Type checking
 	VariantType get_type() const { return _type; }
@@ -198,24 +352,41 @@ class Variant {
 	std::expected<T, std::string> as() const {
 		if (get_variant_type<T>() != _type)
 			return std::unexpected("Variant type does not match requested type");
+		return get_unchecked<T>();
+	}
 
+	// Fast path for callers that already know the type matches, e.g. thunks whose
+	// type was validated at registration. Undefined if get_type() differs. Boxed
+	// payloads come back by const reference into the box, objects by reference.
+	template <VariantCompatible T>
+	decltype(auto) get_unchecked() const {
 		if constexpr (std::is_same_v<T, bool>) {
-			return std::get<bool>(_data);
+			return _get<bool>();
 		}
-		else if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
-			return static_cast<T>(std::get<int>(_data));
+		else if constexpr (std::is_integral_v<T>) {
+			return static_cast<T>(_get<int>());
 		}
 		else if constexpr (std::is_floating_point_v<T>) {
-			return static_cast<T>(std::get<real_t>(_data));
+			return static_cast<T>(_get<real_t>());
 		}
 		else if constexpr (std::is_pointer_v<T> && is_reflected_class_type<std::remove_pointer_t<T>>) {
-			return static_cast<T>(std::get<Reflected*>(_data));
+			return static_cast<T>(_get<Reflected*>());
+		}
+		else if constexpr (is_reflected_class_type<T>) {
+			return static_cast<T&>(*static_cast<T*>(_get<Reflected*>()));
 		}
-		else if constexpr (!std::is_pointer_v<T> && is_reflected_class_type<std::remove_reference_t<T>>) {
-			return *static_cast<T*>(std::get<Reflected*>(_data));
+		else {
+			return _get<T>();
 		}
-		else
-			return std::get<T>(_data);
+	}
+
+	// Copies the payload into out if the type matches; out is untouched otherwise
+	template <VariantCompatible T>
+	bool try_get(T& out) const {
+		if (get_variant_type<T>() != _type)
+			return false;
+		out = get_unchecked<T>();
+		return true;
 	}
 
 	// Equality operators
@@ -226,9 +397,6 @@ class Variant {
 	// String conversion for debugging
 	std::string to_string() const;
 
-	// Direct access to internal variant (for advanced usage)
-	const InternalVariant& internal() const { return _data; }
-
 	// Object property access
 	std::string get_name() const;
 
@@ -249,35 +417,39 @@ class Variant {
 	template <class... TArgs>
 	Variant call_internal(std::string_view method_name, TArgs&&... args) const;
 
-	// implicit conversion
-	// In variant.h, inside the Variant class:
-
-	// Implicit conversion operators
-	explicit operator bool() const { return as<bool>().value(); }
-	operator int() const { return as<int>().value(); }
-	operator real_t() const { return as<real_t>().value(); }
-	operator Vector2() const { return as<Vector2>().value(); }
-	operator Vector3() const { return as<Vector3>().value(); }
-	operator Color() const { return as<Color>().value(); }
-	operator Vertex() const { return as<Vertex>().value(); }
-	operator std::string() const { return as<std::string>().value(); }
-	operator Path() const { return as<Path>().value(); }
-	operator RID() const { return as<RID>().value(); }
-	operator VariantArray() const { return as<VariantArray>().value(); }
-	operator Reflected*() const { return as<Reflected*>().value(); }
+	// Implicit conversion operators; a type mismatch is fatal
+	explicit operator bool() const { return _get_checked<bool>(); }
+	operator int() const { return _get_checked<int>(); }
+	operator real_t() const { return _get_checked<real_t>(); }
+	operator Vector2() const { return _get_checked<Vector2>(); }
+	operator Vector3() const { return _get_checked<Vector3>(); }
+	operator Color() const { return _get_checked<Color>(); }
+	operator Vertex() const { return _get_checked<Vertex>(); }
+	operator std::string() const { return _get_checked<std::string>(); }
+	operator Path() const { return _get_checked<Path>(); }
+	operator RID() const { return _get_checked<RID>(); }
+	operator VariantArray() const { return _get_checked<VariantArray>(); }
+	operator PackedByteArray() const { return _get_checked<PackedByteArray>(); }
+	operator PackedInt32Array() const { return _get_checked<PackedInt32Array>(); }
+	operator PackedFloat32Array() const { return _get_checked<PackedFloat32Array>(); }
+	operator PackedVector3Array() const { return _get_checked<PackedVector3Array>(); }
+	operator PackedVertexArray() const { return _get_checked<PackedVertexArray>(); }
+	operator Reflected*() const { return _get_checked<Reflected*>(); }
 };
 
+static_assert(sizeof(Variant) <= 16, "Variant should stay within two machine words");
+
 template <class... TArgs>
 Variant Variant::call(std::string_view method_name, TArgs&&... args) const {
 	fassert(_type == VariantType::OBJECT, "Variant is not an object");
-	Variant params[] = { as<Reflected*>().value(), args... };
+	Variant params[] = { get_unchecked<Reflected*>(), args... };
 	return _internal_call(method_name, std::span<Variant>(params, sizeof...(args) + 1), true);
 }
 
 template <class... TArgs>
 Variant Variant::call_internal(std::string_view method_name, TArgs&&... args) const {
 	fassert(_type == VariantType::OBJECT, "Variant is not an object");
-	Variant params[] = { as<Reflected*>().value(), args... };
+	Variant params[] = { get_unchecked<Reflected*>(), args... };
 	return _internal_call(method_name, std::span<Variant>(params, sizeof...(args) + 1), false);
 }
 
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace feather {
+
+// Chase-Lev deque (with the memory orderings of Lê et al., "Correct and
+// Efficient Work-Stealing for Weak Memory Models"). The owning thread pushes
+// and pops at the bottom; any thread may steal from the top. T is a pointer,
+// and null means "nothing there".
+//
+// The ring grows when full. Replaced rings are kept until the deque is
+// destroyed, since a thief may still be reading one.
+template <class T>
+	requires std::is_pointer_v<T>
+class WorkStealingDeque {
+	struct Ring {
+		int64_t capacity;
+		int64_t mask;
+		std::unique_ptr<std::atomic<T>[]> slots;
+
+		explicit Ring(int64_t cap) : capacity(cap), mask(cap - 1), slots(new std::atomic<T>[cap]) {}
+
+		T get(int64_t i) const noexcept { return slots[i & mask].load(std::memory_order_relaxed); }
+		void put(int64_t i, T value) noexcept { slots[i & mask].store(value, std::memory_order_relaxed); }
+	};
+
+	// Top and bottom on separate cache lines: thieves hammer one, the owner the other
+	alignas(64) std::atomic<int64_t> _top { 0 };
+	alignas(64) std::atomic<int64_t> _bottom { 0 };
+	std::atomic<Ring*> _ring;
+	// Owner only
+	std::vector<std::unique_ptr<Ring>> _rings;
+
+	Ring* _grow(Ring* ring, int64_t top, int64_t bottom) {
+		auto grown = std::make_unique<Ring>(ring->capacity * 2);
+		for (int64_t i = top; i < bottom; ++i) {
+			grown->put(i, ring->get(i));
+		}
+		Ring* result = grown.get();
+		_rings.push_back(std::move(grown));
+		_ring.store(result, std::memory_order_release);
+		return result;
+	}
+
+public:
+	// capacity must be a power of two
+	explicit WorkStealingDeque(int64_t capacity = 1024) {
+		_rings.push_back(std::make_unique<Ring>(capacity));
+		_ring.store(_rings.back().get(), std::memory_order_relaxed);
+	}
+
+	WorkStealingDeque(const WorkStealingDeque&) = delete;
+	WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+	// Owner only
+	void push(T value) {
+		const int64_t bottom = _bottom.load(std::memory_order_relaxed);
+		const int64_t top = _top.load(std::memory_order_acquire);
+		Ring* ring = _ring.load(std::memory_order_relaxed);
+		if (bottom - top > ring->capacity - 1) {
+			ring = _grow(ring, top, bottom);
+		}
+		ring->put(bottom, value);
+		// Release store rather than the paper's fence + relaxed store: same cost,
+		// and visible to ThreadSanitizer
+		_bottom.store(bottom + 1, std::memory_order_release);
+	}
+
+	// Owner only; newest first
+	T pop() {
+		const int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+		Ring* ring = _ring.load(std::memory_order_relaxed);
+		_bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t top = _top.load(std::memory_order_relaxed);
+
+		if (top > bottom) {
+			_bottom.store(bottom + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		T value = ring->get(bottom);
+		if (top == bottom) {
+			// Last element: race thieves for it
+			if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				value = nullptr;
+			_bottom.store(bottom + 1, std::memory_order_relaxed);
+		}
+		return value;
+	}
+
+	// Any thread; oldest first. Null when empty or when another thread won the race.
+	T steal() {
+		int64_t top = _top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const int64_t bottom = _bottom.load(std::memory_order_acquire);
+		if (top >= bottom)
+			return nullptr;
+
+		T value = _ring.load(std::memory_order_acquire)->get(top);
+		if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			return nullptr;
+		return value;
+	}
+
+	bool empty() const noexcept {
+		return _bottom.load(std::memory_order_relaxed) <= _top.load(std::memory_order_relaxed);
+	}
+};
+
+} // namespace feather
@@ -1,6 +1,7 @@
 #include "class_db.h"
 #include "framework/reflected.h"
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <ranges>
 
@@ -10,15 +11,30 @@ namespace feather {
 
 FSINGLETON_INSTANCE(ClassDB);
 
+namespace {
+
+// See ClassInfo::get_id_sequence
+std::atomic<uint32_t> class_id_sequence { 0 };
+
+} // namespace
+
+const std::atomic<uint32_t>& ClassInfo::get_id_sequence() {
+	return class_id_sequence;
+}
+
 ClassDB::ClassDB() {
 	FSINGLETON_CONSTRUCT_INSTANCE()
-	_class_infos.insert(std::make_pair("Reflected", ClassInfo { .name = "Reflected"_ss, .parent = ""_ss }));
+	ClassInfo& root = _class_infos["Reflected"_ss];
+	root.name = "Reflected"_ss;
+	root.parent = ""_ss;
+	_assign_class_ids();
 }
 
 Reflected* ClassDB::create_object_unsafe(std::string_view name) {
 	auto object_info_it = _instance->_class_infos.find(name);
-	if (object_info_it != _instance->_class_infos.end()) {
-		return object_info_it->second.object_create_func().as<Reflected*>().value();
+	// Abstract, singleton and value classes have no factory
+	if (object_info_it != _instance->_class_infos.end() && object_info_it->second.object_create_func) {
+		return object_info_it->second.object_create_func();
 	}
 
 	return {};
@@ -45,6 +61,14 @@ ClassInfo* ClassDB::_get_class_info_internal(std::string_view name) {
 	return nullptr;
 }
 
+const ClassInfo* ClassDB::find_class_info(std::string_view name) {
+	return _get_class_info_internal(name);
+}
+
+size_t ClassDB::get_class_count() {
+	return get()->_class_infos.size();
+}
+
 std::vector<StaticString> ClassDB::get_children_names(std::string_view object_name, bool exclusive) {
 	if (auto it = ClassDB::get()->_class_infos.find(object_name); it != ClassDB::get()->_class_infos.end()) {
 		return _get_children_names_internal(it->second, exclusive);
@@ -66,29 +90,123 @@ std::string ClassDB::get_children_names_string(StaticString object_name, bool ex
 Delegate<std::string_view>::id_t
 ClassDB::on_subclass_registered(std::string_view base_class_name,
 								const Delegate<std::string_view>::DelegateFuncType& callback) {
-	return get()->_subclass_delegates[StaticString(base_class_name)].subscribe(callback);
+	return get()->_subclass_delegates[StaticString::intern(base_class_name)].subscribe(callback);
+}
+
+ClassDB::RegistrationBatch::RegistrationBatch() {
+	++get()->_batch_depth;
+}
+
+ClassDB::RegistrationBatch::~RegistrationBatch() {
+	ClassDB& instance = *get();
+	if (--instance._batch_depth > 0)
+		return;
+
+	_assign_class_ids();
+	// Delegates may register more classes, which then finish right away
+	const std::vector<StaticString> classes = std::move(instance._batched_classes);
+	instance._batched_classes.clear();
+	for (StaticString class_name : classes) {
+		_fire_subclass_delegates(class_name);
+	}
+}
+
+void ClassDB::_finish_registration(StaticString class_name) {
+	ClassDB& instance = *get();
+	if (instance._batch_depth > 0) {
+		instance._batched_classes.push_back(class_name);
+		return;
+	}
+	_assign_class_ids();
+	_fire_subclass_delegates(class_name);
 }
 
 void ClassDB::_fire_subclass_delegates(std::string_view class_name) {
-	ClassInfo* ci = _get_class_info_internal(class_name);
-	while (ci && ci->parent != ""_ss) {
-		auto it = get()->_subclass_delegates.find(ci->parent);
-		if (it != get()->_subclass_delegates.end()) {
-			it->second.execute(class_name);
+	const ClassInfo* ci = _get_class_info_internal(class_name);
+	if (!ci) {
+		return;
+	}
+	// Few classes have subscribers, so test each against the range instead of walking up
+	for (auto& [base_name, delegate] : get()->_subclass_delegates) {
+		const ClassInfo* base = _get_class_info_internal(base_name);
+		if (base && base != ci && ci->is_a(*base)) {
+			delegate.execute(class_name);
 		}
-		ci = _get_class_info_internal(ci->parent);
 	}
 }
 
-bool ClassDB::has_parent(StaticString object_name, StaticString parent_name) {
-	ClassInfo* ci = _get_class_info_internal(object_name);
-	while (ci && ci->parent != ""_ss) {
-		if (ci->parent == parent_name) {
-			return true;
+void ClassDB::_assign_class_ids() {
+	// Sequence lock writer (see ClassInfo::is_a): odd while the ids change
+	class_id_sequence.fetch_add(1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	uint32_t next_id = 0;
+	for (auto& [name, info] : get()->_class_infos) {
+		// Roots, including placeholders for parents that haven't registered yet
+		if (info.parent == ""_ss || !_get_class_info_internal(info.parent)) {
+			_assign_subtree_ids(info, next_id);
+		}
+	}
+
+	class_id_sequence.fetch_add(1, std::memory_order_release);
+}
+
+void ClassDB::_assign_subtree_ids(ClassInfo& info, uint32_t& next_id) {
+	info.class_id.store(next_id++, std::memory_order_relaxed);
+	for (const ClassInfo* child : info.children) {
+		_assign_subtree_ids(*_get_class_info_internal(child->name), next_id);
+	}
+	info.subtree_end.store(next_id, std::memory_order_relaxed);
+}
+
+void ClassDB::_build_member_tables(ClassInfo& info) {
+	info.property_table.clear();
+	info.method_table.clear();
+
+	// Most derived first: the tables keep the first member seen under a name
+	for (const ClassInfo* ci = &info; ci; ci = ci->parent != ""_ss ? _get_class_info_internal(ci->parent) : nullptr) {
+		for (const ClassInfo::Property& property : ci->properties) {
+			// Entries the descriptor couldn't marshal have no accessors
+			if (property.getter || property.setter)
+				info.property_table.insert(property);
+		}
+		for (const ClassInfo::Method& method : ci->methods) {
+			if (method.callable.is_valid())
+				info.method_table.insert(method);
+		}
+		for (const ClassInfo::Method& method : ci->bound_methods) {
+			info.method_table.insert(method);
 		}
-		ci = _get_class_info_internal(ci->parent);
 	}
-	return false;
+
+	// Descendants registered before this class inherited nothing from it yet
+	for (const ClassInfo* child : info.children) {
+		_build_member_tables(*_get_class_info_internal(child->name));
+	}
+}
+
+void ClassDB::bind_descriptors(std::span<const ClassInfo::Property> properties,
+							   std::span<const ClassInfo::Method> methods) {
+	if (!get()->_current_info) {
+		return;
+	}
+
+	get()->_current_info->properties = properties;
+	get()->_current_info->methods = methods;
+}
+
+void ClassDB::_property_type_mismatch(VariantType expected, VariantType actual) {
+	fassert(false,
+			std::format("Property setter expected Variant type {} and got {}",
+						std::to_underlying(expected),
+						std::to_underlying(actual)));
+	std::unreachable();
+}
+
+bool ClassDB::has_parent(StaticString object_name, StaticString parent_name) {
+	const ClassInfo* ci = _get_class_info_internal(object_name);
+	const ClassInfo* parent = _get_class_info_internal(parent_name);
+	return ci && parent && ci != parent && ci->is_a(*parent);
 }
 
 void ClassDB::print_db() {
@@ -110,13 +228,27 @@ Callable ClassDB::get_static_method(const StaticString& class_name, std::string_
 	auto ci = _get_class_info_internal(class_name);
 	if (!ci)
 		return {};
-	auto it = std::find_if(
-			ci->methods.begin(), ci->methods.end(), [&func_name](ClassInfo::Method& m) { return m.name == func_name; });
+	const ClassInfo::Method* method = ci->method_table.find(func_name);
+	return method ? method->callable : Callable {};
+}
 
-	if (it != ci->methods.end()) {
-		return it->callable;
-	}
-	return {};
+PropertyHandle
+ClassDB::resolve_property(const StaticString& class_name, std::string_view name, bool enforce_public) {
+	auto ci = _get_class_info_internal(class_name);
+	if (!ci)
+		return {};
+	const ClassInfo::Property* property = ci->property_table.find(name);
+	return property ? PropertyHandle(ci, property, enforce_public) : PropertyHandle {};
+}
+
+MethodHandle ClassDB::resolve_method(const StaticString& class_name, std::string_view name, bool enforce_public) {
+	auto ci = _get_class_info_internal(class_name);
+	if (!ci)
+		return {};
+	const ClassInfo::Method* method = ci->method_table.find(name);
+	if (!method || (enforce_public && method->access != AccessLevel::Public))
+		return {};
+	return MethodHandle(ci, method);
 }
 
 } //namespace feather
\ No newline at end of file
@@ -9,10 +9,17 @@
 
 #include <framework/delegate.h>
 
+#include "member_handle.h"
+
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 namespace feather {
@@ -24,27 +31,110 @@ class ClassDB {
 
 	ClassDB();
 
-	std::map<StaticString, ClassInfo> _class_infos;
+	// Node-based, so ClassInfo addresses (children, member tables) stay stable
+	std::unordered_map<StaticString, ClassInfo> _class_infos;
 	std::map<StaticString, Delegate<const std::string_view>> _subclass_delegates;
 
 	ClassInfo* _current_info = nullptr;
 
+	// See RegistrationBatch
+	uint32_t _batch_depth = 0;
+	std::vector<StaticString> _batched_classes;
+
+	// Assigns class ids and fires subclass delegates, or leaves both to the
+	// end of the current batch
+	static void _finish_registration(StaticString class_name);
 	static void _fire_subclass_delegates(std::string_view class_name);
+	// Flattens own + inherited members of info and of every registered descendant
+	static void _build_member_tables(ClassInfo& info);
+	// Renumbers every class in preorder, O(classes); see ClassInfo::class_id
+	static void _assign_class_ids();
+	static void _assign_subtree_ids(ClassInfo& info, uint32_t& next_id);
 
 	template <typename T, typename U>
 	static constexpr size_t offset_of(U T::* member) {
 		return reinterpret_cast<size_t>(&(static_cast<T*>(nullptr)->*member));
 	}
 
+	// Class and value type behind a describe_property accessor
+	template <class TAccessor>
+	struct _AccessorTraits;
+
+	template <class T, class U>
+		requires std::is_member_object_pointer_v<U T::*>
+	struct _AccessorTraits<U T::*> {
+		using Class = T;
+		using Value = U;
+	};
+
+	template <class T, class TGet>
+	struct _AccessorTraits<TGet (T::*)() const> {
+		using Class = T;
+		using Value = std::decay_t<TGet>;
+	};
+
+	template <class T, class TSet>
+	struct _AccessorTraits<void (T::*)(TSet)> {
+		using Class = T;
+		using Value = std::decay_t<TSet>;
+	};
+
+	template <auto Getter>
+	static Variant _property_getter(void* object);
+
+	template <auto Setter>
+	static void _property_setter(void* object, const Variant& value);
+	[[noreturn]] static void _property_type_mismatch(VariantType expected, VariantType actual);
+
 	static std::vector<StaticString> _get_children_names_internal(const ClassInfo& object, bool exclusive = false);
 
 	static ClassInfo* _get_class_info_internal(std::string_view name);
 
+	// Whether info is T or a subclass of it
+	template <class T>
+	static bool _is_class_of(const ClassInfo& info);
+
 public:
 	void print_db();
 
 	static Callable get_static_method(const StaticString& class_name, std::string_view func_name);
 
+	// Registers classes in bulk (see Main::setup_db): class ids are assigned
+	// once when the batch ends rather than per class, which would make startup
+	// quadratic, and subclass delegates fire then, in registration order. Until
+	// the batch ends, is-a checks involving its classes don't hold. Batches
+	// nest; main thread only, like all registration.
+	class RegistrationBatch {
+	public:
+		RegistrationBatch();
+		~RegistrationBatch();
+
+		RegistrationBatch(const RegistrationBatch&) = delete;
+		RegistrationBatch& operator=(const RegistrationBatch&) = delete;
+	};
+
+	// Info of a registered class, cached per T after the first successful lookup
+	template <is_reflected_class_type T>
+	static const ClassInfo* get_class_info();
+	// Null when no class of that name registered
+	static const ClassInfo* find_class_info(std::string_view name);
+	static size_t get_class_count();
+
+#ifdef FEATHER_BENCH
+	// For bench/: the database without Main, and the renumbering registration
+	// did after every class before RegistrationBatch existed
+	static void create_for_bench() { new ClassDB(); }
+	static void renumber_class_ids() { _assign_class_ids(); }
+#endif
+
+	// Resolve a member once for repeated or batched access. With enforce_public,
+	// accessors/methods that aren't Public resolve as unavailable, matching
+	// Variant::get/set/call; pass false for the *_internal behaviour.
+	static PropertyHandle
+	resolve_property(const StaticString& class_name, std::string_view name, bool enforce_public = true);
+	static MethodHandle
+	resolve_method(const StaticString& class_name, std::string_view name, bool enforce_public = true);
+
 	template <is_reflected_class_type T>
 	static void register_class();
 
@@ -60,47 +150,34 @@ class ClassDB {
 		requires(!std::is_base_of_v<Reflected, T>)
 	static void register_value_class();
 
-	// Property backed directly by a data member; both accessors share its access level.
-	template <class T, class U>
-	static void bind_property(U T::* member, std::string_view name, AccessLevel access = AccessLevel::Public);
-
-	// Property backed by explicit getter/setter member functions, with
-	// independent accessibility per accessor. Read-only/write-only overloads
-	// exist because a null member pointer can't be deduced.
-	template <class T, class TGet, class TSet>
-	static void bind_property_accessors(TGet (T::*getter)() const,
-										void (T::*setter)(TSet),
-										std::string_view name,
-										AccessLevel getter_access = AccessLevel::Public,
-										AccessLevel setter_access = AccessLevel::Public);
-
-	template <class T, class TGet>
-	static void
-	bind_property_get(TGet (T::*getter)() const, std::string_view name, AccessLevel access = AccessLevel::Public);
-
-	template <class T, class TSet>
-	static void
-	bind_property_set(void (T::*setter)(TSet), std::string_view name, AccessLevel access = AccessLevel::Public);
-
-	// Guarded binds: no-op when the property type isn't Variant-marshalable
-	// (e.g. std::shared_ptr<...>), so generated accessors never break the build.
-	template <class T, class TGet, class TSet>
-	static void bind_property_accessors_if_bindable(TGet (T::*getter)() const,
-													void (T::*setter)(TSet),
-													std::string_view name,
-													AccessLevel getter_access = AccessLevel::Public,
-													AccessLevel setter_access = AccessLevel::Public);
-
-	template <class T, class TGet>
-	static void bind_property_get_if_bindable(TGet (T::*getter)() const,
-											  std::string_view name,
-											  AccessLevel access = AccessLevel::Public);
-
-	template <class T, class TSet>
-	static void bind_property_set_if_bindable(void (T::*setter)(TSet),
-											  std::string_view name,
-											  AccessLevel access = AccessLevel::Public);
-
+	// Descriptor entries, emitted by the codegen into constexpr arrays that
+	// ClassInfo then references in place. Getter/Setter are each a data member
+	// pointer, an accessor member function (TGet (T::*)() const / void (T::*)(TSet))
+	// or nullptr when the property lacks that accessor. A property whose type
+	// isn't Variant-marshalable (e.g. std::shared_ptr<...>) gets no accessors
+	// and is left out of the member tables, so generated accessors never break
+	// the build.
+	template <auto Getter, auto Setter>
+	static constexpr ClassInfo::Property describe_property(StaticString name,
+														   AccessLevel getter_access = AccessLevel::Public,
+														   AccessLevel setter_access = AccessLevel::Public);
+
+	// Member or static function; the object is passed as the first parameter of a member
+	template <auto Method>
+	static constexpr ClassInfo::Method describe_method(StaticString name, AccessLevel access = AccessLevel::Public);
+
+	// describe_method, but an entry left out of the member tables when the
+	// signature isn't Variant-marshalable
+	template <auto Method>
+	static constexpr ClassInfo::Method
+	describe_method_if_bindable(StaticString name, AccessLevel access = AccessLevel::Public);
+
+	// Called from a generated _bind_members() with its descriptor arrays (static
+	// locals, so they are referenced rather than copied)
+	static void bind_descriptors(std::span<const ClassInfo::Property> properties,
+								 std::span<const ClassInfo::Method> methods);
+
+	// Runtime binding, for members a codegen modifier adds by statement
 	template <class T, class TRet, class... TArgs>
 	static void
 	bind_method(TRet (T::*method)(TArgs...), std::string_view name, AccessLevel access = AccessLevel::Public);
@@ -113,18 +190,6 @@ class ClassDB {
 	static void
 	bind_static_method(TRet (*method)(TArgs...), std::string_view name, AccessLevel access = AccessLevel::Public);
 
-	// Guarded bind_method: no-op when the signature isn't Variant-marshalable.
-	// Used for auto-bound (opt-out) methods; explicit [[method]] uses bind_method directly.
-	template <class T, class TRet, class... TArgs>
-	static void bind_method_if_bindable(TRet (T::*method)(TArgs...),
-										std::string_view name,
-										AccessLevel access = AccessLevel::Public);
-
-	template <class T, class TRet, class... TArgs>
-	static void bind_method_if_bindable(TRet (T::*method)(TArgs...) const,
-										std::string_view name,
-										AccessLevel access = AccessLevel::Public);
-
 	// Returns an unmanaged raw pointer to a reflected object
 	static Reflected* create_object_unsafe(std::string_view object_name);
 
@@ -136,6 +201,16 @@ class ClassDB {
 		return ptr;
 	}
 
+	// Allocated from the class's ObjectPool instead of the heap; null when the
+	// class isn't creatable or isn't a T
+	template <class T = Reflected>
+	static PooledObject<T> create_pooled_object(std::string_view object_name);
+
+	// count objects in adjacent pool slots, constructed in order; each one is
+	// still owned and released on its own
+	template <class T = Reflected>
+	static std::vector<PooledObject<T>> create_objects(std::string_view object_name, size_t count);
+
 	static Delegate<std::string_view>::id_t
 	on_subclass_registered(std::string_view base_class_name,
 						   const Delegate<std::string_view>::DelegateFuncType& callback);
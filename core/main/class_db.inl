@@ -7,8 +7,8 @@
 #include <framework/singleton_helpers.h>
 #include <framework/variant.h>
 
+#include <atomic>
 #include <concepts>
-#include <print>
 #include <type_traits>
 
 namespace feather {
@@ -23,6 +23,19 @@ concept has_bind_method_v = requires(T t) {
 	{ has_bind_method(t) };
 };
 
+template <is_reflected_class_type T>
+const ClassInfo* ClassDB::get_class_info() {
+	// ClassInfo nodes never move, so a found pointer stays valid for good
+	static std::atomic<const ClassInfo*> cached = nullptr;
+	const ClassInfo* info = cached.load(std::memory_order_acquire);
+	if (!info) [[unlikely]] {
+		info = _get_class_info_internal(T::get_class_static());
+		if (info)
+			cached.store(info, std::memory_order_release);
+	}
+	return info;
+}
+
 template <is_reflected_class_type T>
 void ClassDB::register_class() {
 	static_assert(is_reflected_class_type<T>, "Attempt to register a non reflected class type");
@@ -35,15 +48,18 @@ void ClassDB::register_class() {
 	else {
 		static_assert(std::is_default_constructible<T>(), "Trying to register class that is not default constructible");
 		static_assert(has_bind_method_v<T>, "Class doesn't have a static _bind_members function");
-		std::println("Registering class '{}' as {} object", T::get_class_static(), "implementation");
 		ClassDB& instance = *get();
 
 		ClassInfo& info = instance._class_infos[T::get_class_static()];
-		info.name = T::get_class_static();
+		info.name = StaticString::intern(T::get_class_static());
 		info.parent = T::get_parent_name();
 		info.is_abstract = false;
 		info.is_singleton = false;
-		info.object_create_func = []() -> Variant { return new T(); };
+		info.object_create_func = []() -> Reflected* { return new T(); };
+		info.object_size = sizeof(T);
+		info.object_alignment = alignof(T);
+		info.object_construct_func = [](void* memory) -> Reflected* { return new (memory) T(); };
+		info.object_pool = std::make_unique<ObjectPool>(sizeof(T), alignof(T));
 
 		instance._current_info = &info;
 
@@ -54,19 +70,18 @@ void ClassDB::register_class() {
 		T::_bind_members();
 
 		instance._current_info = nullptr;
-		_fire_subclass_delegates(T::get_class_static());
+		_build_member_tables(info);
+		_finish_registration(T::get_class_static());
 	}
 }
 
 template <is_reflected_class_type T> void ClassDB::register_abstract_class() {
-	std::println("Registering class '{}' as {} object", T::get_class_static(), "abstract");
-
 	static_assert(is_reflected_class_type<T>, "Attempt to register a non reflected class type");
 	static_assert(has_bind_method_v<T>, "Class doesn't have a static _bind_members function");
 	ClassDB& instance = *get();
 
 	ClassInfo& info = instance._class_infos[T::get_class_static()];
-	info.name = T::get_class_static();
+	info.name = StaticString::intern(T::get_class_static());
 	info.parent = T::get_parent_name();
 	info.is_abstract = true;
 	info.is_singleton = false;
@@ -81,18 +96,17 @@ template <is_reflected_class_type T> void ClassDB::register_abstract_class() {
 	T::_bind_members();
 
 	instance._current_info = nullptr;
-	_fire_subclass_delegates(T::get_class_static());
+	_build_member_tables(info);
+	_finish_registration(T::get_class_static());
 }
 
 template <is_reflected_class_type T> void ClassDB::register_singleton_class() {
-	std::println("Registering class '{}' as {} object", T::get_class_static(), "singleton");
-
 	static_assert(is_reflected_class_type<T>, "Attempt to register a non reflected class type");
 	static_assert(has_bind_method_v<T>, "Class doesn't have a static _bind_members function");
 	ClassDB& instance = *get();
 
 	ClassInfo& info = instance._class_infos[T::get_class_static()];
-	info.name = T::get_class_static();
+	info.name = StaticString::intern(T::get_class_static());
 	info.parent = T::get_parent_name();
 	info.is_abstract = false;
 	info.is_singleton = true;
@@ -110,20 +124,19 @@ template <is_reflected_class_type T> void ClassDB::register_singleton_class() {
 	T::_bind_members();
 
 	instance._current_info = nullptr;
-	_fire_subclass_delegates(T::get_class_static());
+	_build_member_tables(info);
+	_finish_registration(T::get_class_static());
 }
 
 template <is_reflected_value_type T>
 	requires(!std::is_base_of_v<Reflected, T>)
 void ClassDB::register_value_class() {
-	std::println("Registering class '{}' as {} object", T::get_class_static(), "value type");
-
 	static_assert(is_reflected_value_type<T>, "Attempt to register a non-value reflected class type");
 	static_assert(has_bind_method_v<T>, "Class doesn't have a static _bind_members function");
 	ClassDB& instance = *get();
 
 	ClassInfo& info = instance._class_infos[T::get_class_static()];
-	info.name = T::get_class_static();
+	info.name = StaticString::intern(T::get_class_static());
 	info.parent = T::get_parent_name();
 	info.is_abstract = false;
 	info.is_singleton = false;
@@ -141,94 +154,112 @@ void ClassDB::register_value_class() {
 	T::_bind_members();
 
 	instance._current_info = nullptr;
-	_fire_subclass_delegates(T::get_class_static());
+	_build_member_tables(info);
+	_finish_registration(T::get_class_static());
 }
 
-// Property binding
-
-template <class T, class U>
-inline void ClassDB::bind_property(U T::* member, std::string_view name, AccessLevel access) {
-	if (!get()->_current_info) {
-		return;
+template <class T>
+PooledObject<T> ClassDB::create_pooled_object(std::string_view object_name) {
+	ClassInfo* info = _get_class_info_internal(object_name);
+	if (!info || !info->object_pool || !_is_class_of<T>(*info)) {
+		return {};
 	}
 
-	ClassInfo::Property prop {
-		.name = StaticString(name), .type = get_variant_type<U>(), .getter_access = access, .setter_access = access
-	};
-
-	// Getter : takes void*(will be cast to T*), returns Variant
-	prop.getter = [member](void* obj_ptr) -> Variant {
-		T* typed_ptr = static_cast<T*>(obj_ptr);
-		return Variant(typed_ptr->*member);
-	};
-
-	// Setter: takes void* and Variant, sets the member
-	prop.setter = [member, name](void* obj_ptr, Variant val) {
-		auto result = val.as<U>();
-		fassert(result.has_value(), std::format("Property '{}': setter called with incompatible Variant type", name));
-		static_cast<T*>(obj_ptr)->*member = std::move(result.value());
-	};
-
-	get()->_current_info->properties.push_back(std::move(prop));
+	void* slot = info->object_pool->allocate();
+	return PooledObject<T>(static_cast<T*>(info->object_construct_func(slot)), { info->object_pool.get() });
 }
 
-// Property backed by explicit getter + setter member functions.
-template <class T, class TGet, class TSet>
-inline void ClassDB::bind_property_accessors(TGet (T::*getter)() const,
-											 void (T::*setter)(TSet),
-											 std::string_view name,
-											 AccessLevel getter_access,
-											 AccessLevel setter_access) {
-	if (!get()->_current_info) {
-		return;
+template <class T>
+std::vector<PooledObject<T>> ClassDB::create_objects(std::string_view object_name, size_t count) {
+	std::vector<PooledObject<T>> objects;
+	ClassInfo* info = _get_class_info_internal(object_name);
+	if (!info || !info->object_pool || !_is_class_of<T>(*info) || count == 0) {
+		return objects;
 	}
-	using U = std::decay_t<TGet>;
-
-	ClassInfo::Property prop { .name = StaticString(name),
-							   .type = get_variant_type<U>(),
-							   .getter_access = getter_access,
-							   .setter_access = setter_access };
-
-	prop.getter = [getter](void* obj_ptr) -> Variant { return Variant((static_cast<T*>(obj_ptr)->*getter)()); };
-	prop.setter = [setter, name](void* obj_ptr, Variant val) {
-		auto result = val.as<std::decay_t<TSet>>();
-		fassert(result.has_value(), std::format("Property '{}': setter called with incompatible Variant type", name));
-		(static_cast<T*>(obj_ptr)->*setter)(std::move(result.value()));
-	};
 
-	get()->_current_info->properties.push_back(std::move(prop));
+	objects.reserve(count);
+	std::byte* slot = static_cast<std::byte*>(info->object_pool->allocate_run(count));
+	for (size_t i = 0; i < count; ++i, slot += info->object_pool->slot_size()) {
+		objects.emplace_back(static_cast<T*>(info->object_construct_func(slot)),
+							 ObjectPool::Deleter { info->object_pool.get() });
+	}
+	return objects;
 }
 
-// Read-only property (getter only).
-template <class T, class TGet>
-inline void ClassDB::bind_property_get(TGet (T::*getter)() const, std::string_view name, AccessLevel access) {
-	if (!get()->_current_info) {
-		return;
-	}
-	using U = std::decay_t<TGet>;
+template <class T>
+bool ClassDB::_is_class_of(const ClassInfo& info) {
+	const ClassInfo* base = get_class_info<std::remove_const_t<T>>();
+	return base && info.is_a(*base);
+}
 
-	ClassInfo::Property prop { .name = StaticString(name), .type = get_variant_type<U>(), .getter_access = access };
-	prop.getter = [getter](void* obj_ptr) -> Variant { return Variant((static_cast<T*>(obj_ptr)->*getter)()); };
+// Descriptors
 
-	get()->_current_info->properties.push_back(std::move(prop));
+template <auto Getter>
+Variant ClassDB::_property_getter(void* object) {
+	using T = typename _AccessorTraits<decltype(Getter)>::Class;
+	T* typed_ptr = static_cast<T*>(object);
+	if constexpr (std::is_member_object_pointer_v<decltype(Getter)>) {
+		return Variant(typed_ptr->*Getter);
+	}
+	else {
+		return Variant((typed_ptr->*Getter)());
+	}
 }
 
-// Write-only property (setter only).
-template <class T, class TSet>
-inline void ClassDB::bind_property_set(void (T::*setter)(TSet), std::string_view name, AccessLevel access) {
-	if (!get()->_current_info) {
-		return;
+template <auto Setter>
+void ClassDB::_property_setter(void* object, const Variant& value) {
+	using T = typename _AccessorTraits<decltype(Setter)>::Class;
+	using U = typename _AccessorTraits<decltype(Setter)>::Value;
+	// U was checked to be marshalable when the descriptor was built, so only the tag is left
+	if (value.get_type() != get_variant_type<U>()) [[unlikely]]
+		_property_type_mismatch(get_variant_type<U>(), value.get_type());
+	T* typed_ptr = static_cast<T*>(object);
+	if constexpr (std::is_member_object_pointer_v<decltype(Setter)>) {
+		typed_ptr->*Setter = value.get_unchecked<U>();
+	}
+	else {
+		(typed_ptr->*Setter)(value.get_unchecked<U>());
 	}
-	using U = std::decay_t<TSet>;
+}
+
+template <auto Getter, auto Setter>
+constexpr ClassInfo::Property
+ClassDB::describe_property(StaticString name, AccessLevel getter_access, AccessLevel setter_access) {
+	constexpr bool has_getter = !std::is_null_pointer_v<decltype(Getter)>;
+	constexpr bool has_setter = !std::is_null_pointer_v<decltype(Setter)>;
+	static_assert(has_getter || has_setter, "A property needs a getter or a setter");
+
+	using U = typename _AccessorTraits<std::conditional_t<has_getter, decltype(Getter), decltype(Setter)>>::Value;
+	using USet = typename _AccessorTraits<std::conditional_t<has_setter, decltype(Setter), decltype(Getter)>>::Value;
 
-	ClassInfo::Property prop { .name = StaticString(name), .type = get_variant_type<U>(), .setter_access = access };
-	prop.setter = [setter, name](void* obj_ptr, Variant val) {
-		auto result = val.as<std::decay_t<TSet>>();
-		fassert(result.has_value(), std::format("Property '{}': setter called with incompatible Variant type", name));
-		(static_cast<T*>(obj_ptr)->*setter)(std::move(result.value()));
+	ClassInfo::Property prop {
+		.name = name, .type = get_variant_type<U>(), .getter_access = getter_access, .setter_access = setter_access
 	};
+	if constexpr (VariantCompatible<U> && VariantCompatible<USet>) {
+		if constexpr (has_getter) {
+			prop.getter = &_property_getter<Getter>;
+		}
+		if constexpr (has_setter) {
+			prop.setter = &_property_setter<Setter>;
+		}
+		if constexpr (get_variant_type<USet>() == VariantType::OBJECT) {
+			prop.object_class = &get_class_info<std::remove_cv_t<std::remove_pointer_t<USet>>>;
+			prop.object_nullable = std::is_pointer_v<USet>;
+		}
+	}
+	return prop;
+}
 
-	get()->_current_info->properties.push_back(std::move(prop));
+template <auto Method>
+constexpr ClassInfo::Method ClassDB::describe_method(StaticString name, AccessLevel access) {
+	if constexpr (std::is_member_function_pointer_v<decltype(Method)>) {
+		return ClassInfo::Method { .name = name, .access = access, .callable = Callable::from_method<Method>() };
+	}
+	else {
+		// No instance parameter needed for static functions
+		return ClassInfo::Method { .name = name, .access = access, .callable = Callable::from_function<Method>(),
+								   .is_static = true };
+	}
 }
 
 // Method binding
@@ -238,14 +269,12 @@ inline void ClassDB::bind_method(TRet (T::*method)(TArgs...), std::string_view n
 		return;
 	}
 
-	// Create a function that takes T* as first parameter, then the method args
-	std::function<TRet(Reflected*, TArgs...)> func = [method](Reflected* instance, TArgs... args) -> TRet {
-		return (object_cast<T>(instance)->*method)(args...);
-	};
-
-	ClassInfo::Method method_info { .name = StaticString(name), .access = access, .callable = Callable { func } };
+	// The object is passed as the first parameter, followed by the method args
+	ClassInfo::Method method_info { .name = StaticString::intern(name),
+									.access = access,
+									.callable = Callable::from_method(method) };
 
-	get()->_current_info->methods.push_back(std::move(method_info));
+	get()->_current_info->bound_methods.push_back(std::move(method_info));
 }
 
 template <class T, class TRet, class... TArgs>
@@ -254,14 +283,12 @@ inline void ClassDB::bind_method(TRet (T::*method)(TArgs...) const, std::string_
 		return;
 	}
 
-	// Create a function that takes T* as first parameter, then the method args
-	std::function<TRet(Reflected*, TArgs...)> func = [method](Reflected* instance, TArgs... args) -> TRet {
-		return (object_cast<T>(instance)->*method)(args...);
-	};
-
-	ClassInfo::Method method_info { .name = StaticString(name), .access = access, .callable = Callable { func } };
+	// The object is passed as the first parameter, followed by the method args
+	ClassInfo::Method method_info { .name = StaticString::intern(name),
+									.access = access,
+									.callable = Callable::from_method(method) };
 
-	get()->_current_info->methods.push_back(std::move(method_info));
+	get()->_current_info->bound_methods.push_back(std::move(method_info));
 }
 
 template <class TRet, class... TArgs>
@@ -271,38 +298,11 @@ inline void ClassDB::bind_static_method(TRet (*method)(TArgs...), std::string_vi
 	}
 
 	// No instance parameter needed for static functions
-	std::function<TRet(TArgs...)> func = [method](TArgs... args) -> TRet { return method(args...); };
-
-	ClassInfo::Method method_info { .name = StaticString(name), .access = access, .callable = Callable { func } };
-
-	get()->_current_info->methods.push_back(std::move(method_info));
-}
-
-// Guarded property binds — no-op when the property type isn't Variant-marshalable.
-template <class T, class TGet, class TSet>
-inline void ClassDB::bind_property_accessors_if_bindable(TGet (T::*getter)() const,
-														 void (T::*setter)(TSet),
-														 std::string_view name,
-														 AccessLevel getter_access,
-														 AccessLevel setter_access) {
-	if constexpr (VariantCompatible<std::decay_t<TGet>> && VariantCompatible<std::decay_t<TSet>>) {
-		bind_property_accessors(getter, setter, name, getter_access, setter_access);
-	}
-}
-
-template <class T, class TGet>
-inline void
-ClassDB::bind_property_get_if_bindable(TGet (T::*getter)() const, std::string_view name, AccessLevel access) {
-	if constexpr (VariantCompatible<std::decay_t<TGet>>) {
-		bind_property_get(getter, name, access);
-	}
-}
+	ClassInfo::Method method_info {
+		.name = StaticString::intern(name), .access = access, .callable = Callable { method }, .is_static = true
+	};
 
-template <class T, class TSet>
-inline void ClassDB::bind_property_set_if_bindable(void (T::*setter)(TSet), std::string_view name, AccessLevel access) {
-	if constexpr (VariantCompatible<std::decay_t<TSet>>) {
-		bind_property_set(setter, name, access);
-	}
+	get()->_current_info->bound_methods.push_back(std::move(method_info));
 }
 
 // A method signature is bindable when its return type and every parameter type
@@ -311,18 +311,28 @@ template <class TRet, class... TArgs>
 concept method_signature_bindable =
 		VariantCompatible<std::decay_t<TRet>> && (VariantCompatible<std::decay_t<TArgs>> && ...);
 
+template <class TRet, class... TArgs>
+consteval bool is_method_bindable(TRet (*)(TArgs...)) {
+	return method_signature_bindable<TRet, TArgs...>;
+}
+
 template <class T, class TRet, class... TArgs>
-inline void ClassDB::bind_method_if_bindable(TRet (T::*method)(TArgs...), std::string_view name, AccessLevel access) {
-	if constexpr (method_signature_bindable<TRet, TArgs...>) {
-		bind_method(method, name, access);
-	}
+consteval bool is_method_bindable(TRet (T::*)(TArgs...)) {
+	return method_signature_bindable<TRet, TArgs...>;
 }
 
 template <class T, class TRet, class... TArgs>
-inline void
-ClassDB::bind_method_if_bindable(TRet (T::*method)(TArgs...) const, std::string_view name, AccessLevel access) {
-	if constexpr (method_signature_bindable<TRet, TArgs...>) {
-		bind_method(method, name, access);
+consteval bool is_method_bindable(TRet (T::*)(TArgs...) const) {
+	return method_signature_bindable<TRet, TArgs...>;
+}
+
+template <auto Method>
+constexpr ClassInfo::Method ClassDB::describe_method_if_bindable(StaticString name, AccessLevel access) {
+	if constexpr (is_method_bindable(Method)) {
+		return describe_method<Method>(name, access);
+	}
+	else {
+		return ClassInfo::Method { .name = name, .access = access, .callable = {} };
 	}
 }
 
@@ -3,10 +3,14 @@
 #include "world/components/light.h"
 #include "world/rendering_world_feature.h"
 
+#include <framework/alloc_tracker.h>
 #include <framework/assert.h>
+#include <framework/profiler.h>
 #include <resources/resource_loader.h>
 
 #include <chrono>
+#include <cmath>
+#include <iostream>
 
 #include <rendering/rendering_server.h>
 #include <resources/mesh.h>
@@ -20,6 +24,7 @@ Engine::Engine() {
 	fassert(!_instance);
 
 	_instance = this;
+	Profiler::set_thread_name("Main");
 	_rendering_server.init();
 }
 
@@ -28,6 +33,37 @@ Engine::~Engine() {
 }
 
 #if BETA
+// CPU-heavy, multi-threaded system for checking how ECS work scales with
+// --ecs-threads (enabled by --ecs-sample): every entity sums a few dozen
+// harmonics each frame
+inline void _setup_parallel_sample(WorldSim& _world_sim) {
+	struct Oscillator {
+		Vector3 origin;
+		real_t phase;
+	};
+
+	auto w = *_world_sim.get_world();
+	constexpr int side = 128;
+	for (int i = 0; i < side * side; ++i) {
+		const Vector3 origin { static_cast<real_t>(i % side), 0, static_cast<real_t>(i / side) };
+		w.entity().set<Oscillator>({ origin, static_cast<real_t>(i) * 0.01f }).emplace<Transform>(
+				origin, Quaternion::identity, Vector3::one
+		);
+	}
+
+	w.system<const Oscillator, Transform>("Oscillate")
+			.multi_threaded()
+			.kind(flecs::OnUpdate)
+			.each([](flecs::iter& it, size_t, const Oscillator& osc, Transform& t) {
+				const real_t time = static_cast<real_t>(it.world().get_info()->world_time_total);
+				real_t height = 0;
+				for (int harmonic = 1; harmonic <= 48; ++harmonic) {
+					height += std::sin(osc.phase * harmonic + time) / static_cast<real_t>(harmonic);
+				}
+				t.position = osc.origin + Vector3 { 0, height, 0 };
+			});
+}
+
 inline void _setup_demo_scene(WorldSim& _world_sim) {
 	// test script
 	auto w = *_world_sim.get_world();
@@ -120,32 +156,56 @@ bool Engine::run() {
 	if (LaunchSettings::get().demo_mode.Get()) {
 		_setup_demo_scene(_world_sim);
 	}
+	if (LaunchSettings::get().ecs_sample.Get()) {
+		_setup_parallel_sample(_world_sim);
+	}
 #endif
 
+	if (LaunchSettings::get().profile) {
+#if FEATHER_PROFILER
+		Profiler::start(LaunchSettings::get().profile.Get());
+#else
+		std::cerr << "--profile ignored: the profiler is compiled out of release builds" << std::endl;
+#endif
+	}
+
 	// update
 	double accumulator = 0.0;
 	while (keep_running) {
+		Profiler::flush();
+		FPROFILE_ZONE("Frame");
+		AllocTracker::begin_frame();
 		keep_running = _main_window.update();
 
+		// Without workers, posted jobs (e.g. resource loads resuming after their
+		// reads) only run when someone waits; give them a turn every frame
+		if (_job_system.get_worker_count() == 0)
+			_job_system.run_pending();
+
 		auto new_time = Clock::now();
 
 		double frame_time = std::chrono::duration_cast<std::chrono::duration<double>>(new_time - current_time).count();
 		current_time = new_time;
 
 		accumulator += frame_time;
-		_current_dt = simulation_time;
-		while (accumulator >= simulation_time) {
-			accumulator -= simulation_time;
-			_world_sim.fixed_update(simulation_time);
+		{
+			AllocTagScope tag { AllocTag::world };
+			_current_dt = simulation_time;
+			while (accumulator >= simulation_time) {
+				FPROFILE_ZONE("WorldSim::fixed_update");
+				accumulator -= simulation_time;
+				_world_sim.fixed_update(simulation_time);
+			}
+
+			_current_dt = frame_time;
+			_world_sim.update(frame_time);
 		}
 
-		_current_dt = frame_time;
-		_world_sim.update(frame_time);
-
 		// Tell the renderer to render here
 		_rendering_server.update(frame_time);
 	}
 
+	Profiler::stop();
 	return true;
 }
 
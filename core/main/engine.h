@@ -1,8 +1,11 @@
 #pragma once
 
+#include "launch_settings.h"
 #include "window.h"
 #include "world_sim.h"
 
+#include <framework/io_executor.h>
+#include <framework/job_system.h>
 #include <rendering/rendering_server.h>
 
 #include <chrono>
@@ -18,6 +21,10 @@ class Engine {
 	friend Main;
 	static Engine* _instance;
 
+	// First, so the workers outlive every system that submits jobs
+	JobSystem _job_system { LaunchSettings::get().job_threads.Get() };
+	// Destroyed before the JobSystem, which resumes the coroutines it completes
+	IoExecutor _io_executor { LaunchSettings::get().io_threads.Get() };
 	RenderingServer _rendering_server;
 	Window _main_window;
 	WorldSim _world_sim;
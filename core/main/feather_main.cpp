@@ -3,6 +3,7 @@
 #include "project_settings.h"
 #include "resources/resource_loader.h"
 
+#include <framework/alloc_tracker.h>
 #include <framework/register_framework_types.gen.h>
 #include <main/register_main_types.gen.h>
 #include <math/register_math_types.gen.h>
@@ -12,6 +13,8 @@
 
 #include <modules/modules.gen.h>
 
+#include <iostream>
+
 namespace feather {
 
 struct Main {
@@ -41,6 +44,10 @@ Main::Main(int argc, char* argv[]) : _class_db(), _launch_settings(std::move(arg
 Main::~Main() = default;
 
 void Main::setup_db() {
+	AllocTagScope tag { AllocTag::reflection };
+	// Numbers the class hierarchy once, after everything has registered
+	ClassDB::RegistrationBatch batch;
+
 	register_framework_types();
 	register_math_types();
 	register_resources_types();
@@ -55,5 +62,8 @@ void Main::setup_db() {
 } //namespace feather
 
 int main(int argc, char* argv[]) {
-	feather::Main fmain(std::move(argc), std::move(argv));
+	{
+		feather::Main fmain(std::move(argc), std::move(argv));
+	}
+	feather::AllocTracker::report_leaks(std::cerr);
 }
\ No newline at end of file
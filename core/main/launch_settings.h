@@ -45,6 +45,34 @@ class LaunchSettings {
 											{ "w" },
 											"windowed" };
 
+	args::ValueFlag<int> job_threads { _parser,
+									   "job threads",
+									   "Worker threads of the job system (default: one per extra hardware thread)",
+									   { "job-threads" },
+									   -1 };
+
+	args::ValueFlag<int> io_threads { _parser,
+									  "io threads",
+									  "Threads doing blocking file reads for async loading",
+									  { "io-threads" },
+									  2 };
+
+	args::ValueFlag<int> ecs_threads { _parser,
+									   "ecs threads",
+									   "Threads running ECS systems, the main one included (default: a quarter of the hardware threads)",
+									   { "ecs-threads" },
+									   -1 };
+
+#if BETA
+	args::ImplicitValueFlag<bool> ecs_sample {
+		_parser, "ecs sample", "Add a CPU-heavy multi-threaded system for checking --ecs-threads scaling", { "ecs-sample" }, true, false
+	};
+#endif
+
+	args::ValueFlag<std::string> profile {
+		_parser, "file", "Write a CPU trace of the run to file (Chrome trace JSON, opens in ui.perfetto.dev)", { "profile" }
+	};
+
 	args::Group rendering { _parser, "Rendering related settings" };
 
 	args::ValueFlag<std::string> renderer;
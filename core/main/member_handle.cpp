@@ -0,0 +1,114 @@
+#include "member_handle.h"
+
+#include <framework/assert.h>
+
+#include <algorithm>
+
+namespace feather {
+
+// Two compares past the virtual call (see ClassInfo::is_a)
+static bool is_object_of(const Reflected* object, const ClassInfo& class_info) {
+	const ClassInfo* info = object ? object->get_class_info() : nullptr;
+	return info && info->is_a(class_info);
+}
+
+PropertyHandle::PropertyHandle(const ClassInfo* class_info, const ClassInfo::Property* property, bool enforce_public)
+		: _class(class_info)
+		, _property(property)
+		, _can_get(property && property->getter && (!enforce_public || property->getter_access == AccessLevel::Public))
+		, _can_set(property && property->setter && (!enforce_public || property->setter_access == AccessLevel::Public)) {
+}
+
+bool PropertyHandle::_accepts(const Reflected* object) const {
+	return is_object_of(object, *_class);
+}
+
+StaticString PropertyHandle::get_name() const {
+	fassert(_property, "Invalid PropertyHandle");
+	return _property->name;
+}
+
+VariantType PropertyHandle::get_type() const {
+	fassert(_property, "Invalid PropertyHandle");
+	return _property->type;
+}
+
+AccessLevel PropertyHandle::get_getter_access() const {
+	fassert(_property, "Invalid PropertyHandle");
+	return _property->getter_access;
+}
+
+AccessLevel PropertyHandle::get_setter_access() const {
+	fassert(_property, "Invalid PropertyHandle");
+	return _property->setter_access;
+}
+
+Variant PropertyHandle::get(Reflected* object) const {
+	if (!_can_get || !_accepts(object)) {
+		return {};
+	}
+	return _property->getter(object);
+}
+
+void PropertyHandle::set(Reflected* object, const Variant& value) const {
+	if (!_can_set || !_accepts(object)) {
+		return;
+	}
+	_property->setter(object, value);
+}
+
+void PropertyHandle::get_many(std::span<Reflected* const> objects, std::span<Variant> out_values) const {
+	fassert(out_values.size() >= objects.size(), "get_many: output span is smaller than the object span");
+	if (!_can_get) {
+		std::fill_n(out_values.begin(), objects.size(), Variant());
+		return;
+	}
+	for (size_t i = 0; i < objects.size(); ++i) {
+		out_values[i] = _accepts(objects[i]) ? _property->getter(objects[i]) : Variant();
+	}
+}
+
+void PropertyHandle::set_many(std::span<Reflected* const> objects, std::span<const Variant> values) const {
+	fassert(values.size() >= objects.size(), "set_many: value span is smaller than the object span");
+	if (!_can_set) {
+		return;
+	}
+	for (size_t i = 0; i < objects.size(); ++i) {
+		if (_accepts(objects[i]))
+			_property->setter(objects[i], values[i]);
+	}
+}
+
+void PropertyHandle::set_many(std::span<Reflected* const> objects, const Variant& value) const {
+	if (!_can_set) {
+		return;
+	}
+	for (Reflected* object : objects) {
+		if (_accepts(object))
+			_property->setter(object, value);
+	}
+}
+
+StaticString MethodHandle::get_name() const {
+	fassert(_method, "Invalid MethodHandle");
+	return _method->name;
+}
+
+AccessLevel MethodHandle::get_access() const {
+	fassert(_method, "Invalid MethodHandle");
+	return _method->access;
+}
+
+Variant MethodHandle::call(std::span<Variant> params) const {
+	if (!_method) {
+		return {};
+	}
+	if (!_method->is_static) {
+		if (params.empty() || params[0].get_type() != VariantType::OBJECT ||
+			!is_object_of(params[0].get_unchecked<Reflected*>(), *_class))
+			return {};
+	}
+	return _method->callable.call(params);
+}
+
+} //namespace feather
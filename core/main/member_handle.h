@@ -0,0 +1,82 @@
+#pragma once
+
+#include <framework/class_info.h>
+#include <framework/reflected.h>
+#include <framework/variant.h>
+
+#include <span>
+
+namespace feather {
+
+class ClassDB;
+
+// A property resolved once through ClassDB::resolve_property, so reading or
+// writing it skips name hashing, the member lookup and the access check. It
+// applies to any object of the class it was resolved on, or of a subclass that
+// doesn't shadow it; other objects read as NIL and ignore writes.
+class PropertyHandle {
+	friend ClassDB;
+
+	// The class the handle was resolved on
+	const ClassInfo* _class = nullptr;
+	const ClassInfo::Property* _property = nullptr;
+	// Accessors the handle was allowed to keep when resolved
+	bool _can_get = false;
+	bool _can_set = false;
+
+	PropertyHandle(const ClassInfo* class_info, const ClassInfo::Property* property, bool enforce_public);
+
+	bool _accepts(const Reflected* object) const;
+
+public:
+	PropertyHandle() = default;
+
+	bool is_valid() const { return _property; }
+	bool can_get() const { return _can_get; }
+	bool can_set() const { return _can_set; }
+
+	StaticString get_name() const;
+	VariantType get_type() const;
+	AccessLevel get_getter_access() const;
+	AccessLevel get_setter_access() const;
+
+	// NIL / ignored when the accessor isn't available, as with Variant::get/set
+	Variant get(Reflected* object) const;
+	void set(Reflected* object, const Variant& value) const;
+
+	// Batch forms: one resolved accessor applied across a span of objects
+	void get_many(std::span<Reflected* const> objects, std::span<Variant> out_values) const;
+	void set_many(std::span<Reflected* const> objects, std::span<const Variant> values) const;
+	void set_many(std::span<Reflected* const> objects, const Variant& value) const;
+};
+
+// A method resolved once through ClassDB::resolve_method; see PropertyHandle.
+class MethodHandle {
+	friend ClassDB;
+
+	const ClassInfo* _class = nullptr;
+	const ClassInfo::Method* _method = nullptr;
+
+	MethodHandle(const ClassInfo* class_info, const ClassInfo::Method* method) : _class(class_info), _method(method) {}
+
+public:
+	MethodHandle() = default;
+
+	bool is_valid() const { return _method; }
+
+	StaticString get_name() const;
+	AccessLevel get_access() const;
+
+	// params[0] is the object, followed by the arguments (the Callable convention).
+	// NIL when that isn't an object of the resolving class; static methods take
+	// only their arguments.
+	Variant call(std::span<Variant> params) const;
+
+	template <class... TArgs>
+	Variant call(Reflected* object, TArgs&&... args) const {
+		Variant params[] = { object, Variant(std::forward<TArgs>(args))... };
+		return call(std::span<Variant>(params, sizeof...(args) + 1));
+	}
+};
+
+} //namespace feather
@@ -1,14 +1,98 @@
 #include "world_sim.h"
 
 #include "engine.h"
+#include "launch_settings.h"
+#include <framework/alloc_tracker.h>
+#include <framework/profiler.h>
 #include <world/components/scene.h>
 #include <world/register_core_features.h>
 #include <framework/static_string.hpp>
 
+#include <algorithm>
+#include <condition_variable>
+#include <format>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
 namespace feather {
 
 FSINGLETON_INSTANCE(WorldSim);
 
+// Thread of one Flecs worker stage. Flecs starts a task per stage each frame
+// and joins them all before progress() returns, both from the thread calling
+// progress(); between frames the stage thread sleeps on cv.
+struct WorldSim::StageThread {
+	std::mutex mutex;
+	std::condition_variable_any cv;
+	ecs_os_thread_callback_t callback = nullptr;
+	void* param = nullptr;
+	void* result = nullptr;
+	bool done = false;
+	// Between task_new and task_join; only touched by the thread calling progress()
+	bool busy = false;
+	// Last, so it is stopped and joined before the rest goes away
+	std::jthread thread;
+
+	explicit StageThread(uint32_t index) : thread([this, index](std::stop_token stop) { _main(stop, index); }) {}
+
+	void _main(std::stop_token stop, uint32_t index) {
+		AllocTagScope tag { AllocTag::world };
+		Profiler::set_thread_name(std::format("ECS Stage {}", index));
+		std::unique_lock lock(mutex);
+		while (cv.wait(lock, stop, [this] { return callback != nullptr; })) {
+			const ecs_os_thread_callback_t function = std::exchange(callback, nullptr);
+			lock.unlock();
+			void* value = function(param);
+			lock.lock();
+			result = value;
+			done = true;
+			cv.notify_all();
+		}
+	}
+};
+
+ecs_os_thread_t WorldSim::_ecs_task_new(ecs_os_thread_callback_t callback, void* param) {
+	auto& stages = get()->_stage_threads;
+	auto it = std::ranges::find_if(stages, [](const auto& stage) { return !stage->busy; });
+	fassert(it != stages.end(), "Flecs started more stages than WorldSim has threads");
+
+	StageThread& stage = **it;
+	stage.busy = true;
+	{
+		std::lock_guard lock(stage.mutex);
+		stage.callback = callback;
+		stage.param = param;
+		stage.done = false;
+	}
+	stage.cv.notify_all();
+	return reinterpret_cast<ecs_os_thread_t>(&stage);
+}
+
+void* WorldSim::_ecs_task_join(ecs_os_thread_t thread) {
+	auto& stage = *reinterpret_cast<StageThread*>(thread);
+	std::unique_lock lock(stage.mutex);
+	stage.cv.wait(lock, [&stage] { return stage.done; });
+	stage.busy = false;
+	return stage.result;
+}
+
+namespace {
+
+#if FEATHER_PROFILER
+// Flecs reports its systems and pipeline steps here when built with FLECS_PERF_TRACE
+void _ecs_perf_trace_push(const char* filename, size_t line, const char* name) {
+	Profiler::begin(name);
+}
+
+void _ecs_perf_trace_pop(const char* filename, size_t line, const char* name) {
+	Profiler::end();
+}
+#endif
+
+} // namespace
+
 WorldSim::WorldSim() : fixed_tick { _world.timer().interval(Engine::simulation_time) } {
 	FSINGLETON_CONSTRUCT_INSTANCE()
 #if BETA
@@ -25,11 +109,37 @@ WorldSim::WorldSim() : fixed_tick { _world.timer().interval(Engine::simulation_t
 	for (auto& child : children) {
 		ClassDB::get_static_method(child, "_import_module").call(this);
 	}
+
+#if FEATHER_PROFILER
+	ecs_os_api.perf_trace_push_ = _ecs_perf_trace_push;
+	ecs_os_api.perf_trace_pop_ = _ecs_perf_trace_pop;
+#endif
+
+	// Stage threads come on top of the JobSystem's workers, so by default only
+	// take a quarter of the hardware threads
+	const int threads = LaunchSettings::get().ecs_threads.Get();
+	set_thread_count(threads >= 0 ? static_cast<uint32_t>(threads) : std::thread::hardware_concurrency() / 4);
+}
+
+void WorldSim::set_thread_count(uint32_t count) {
+	_thread_count = std::clamp<uint32_t>(count, 1, std::max(std::thread::hardware_concurrency(), 1u));
+	if (_thread_count > 1) {
+		// Read whenever Flecs starts its tasks, so setting them after ecs_init is fine
+		ecs_os_api.task_new_ = _ecs_task_new;
+		ecs_os_api.task_join_ = _ecs_task_join;
+	}
+	// Flecs joins its tasks before progress() returns, so no stage is running here
+	_stage_threads.clear();
+	for (uint32_t i = 1; i < _thread_count; ++i) {
+		_stage_threads.push_back(std::make_unique<StageThread>(i));
+	}
+	_world.set_task_threads(static_cast<int32_t>(_thread_count));
 }
 
 WorldSim::~WorldSim() = default;
 
 void WorldSim::update(double delta) {
+	FPROFILE_FUNCTION();
 	// Ecs::query<Transform, MeshInstance, MaterialInstance> q
 
 	bool result = _world.progress(/*delta*/);
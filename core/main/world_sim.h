@@ -9,6 +9,9 @@
 #include <flecs.h>
 #include <flecs/addons/cpp/world.hpp>
 
+#include <memory>
+#include <vector>
+
 #ifndef FEATHER_REFLECTION_PARSER
 #include "world_sim.gen.h"
 #endif
@@ -18,7 +21,16 @@ namespace feather {
 class WorldSim final : public Simulation {
 	FCLASS(singleton);
 
+	// Runs one Flecs worker stage per frame, see world_sim.cpp
+	struct StageThread;
+
 	World _world;
+	uint32_t _thread_count = 1;
+	// One per thread of multi-threaded systems besides the one calling update()
+	std::vector<std::unique_ptr<StageThread>> _stage_threads;
+	// Flecs' task hooks, handing stages to _stage_threads
+	static ecs_os_thread_t _ecs_task_new(ecs_os_thread_callback_t callback, void* param);
+	static void* _ecs_task_join(ecs_os_thread_t thread);
 	Entity _scene_prefab;
 	Entity _current_scene;
 
@@ -59,6 +71,14 @@ class WorldSim final : public Simulation {
 	// get low level world impl
 	[[nodiscard]] World* get_world() { return &_world; }
 
+	// Threads running multi-threaded systems, including the one calling
+	// update(). The others are dedicated threads, parked between frames, not
+	// JobSystem jobs: a stage blocks at every sync point until the rest reach
+	// it, so it must not queue behind other jobs or run nested in a wait().
+	// Clamped to the hardware threads; 1 runs every system on the calling thread.
+	void set_thread_count(uint32_t count);
+	[[nodiscard]] uint32_t get_thread_count() const { return _thread_count; }
+
 	void add_to_scene(Entity entity) const;
 
 	template <class... T>
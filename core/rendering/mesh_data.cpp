@@ -1,10 +1,22 @@
 #include "mesh_data.h"
 
+#include <framework/alloc_tracker.h>
+
 namespace feather {
 
 MeshData::MeshData(std::vector<Vertex> vertices, std::vector<Index> indices)
-		: _vertices { vertices.begin(), vertices.end() }
-		, _indices { indices.begin(), indices.end() } {
+		: _vertices(vertices.begin(), vertices.end(), get_memory_resource())
+		, _indices(indices.begin(), indices.end(), get_memory_resource()) {
+}
+
+std::pmr::memory_resource* MeshData::get_memory_resource() {
+	// Synchronized: meshes are imported by loaders that may run off the main thread.
+	// Never destroyed, so static-lifetime meshes can still free into it at exit.
+	static auto* pool = [] {
+		AllocTagScope tag { AllocTag::permanent };
+		return new std::pmr::synchronized_pool_resource(get_permanent_memory_resource());
+	}();
+	return pool;
 }
 
 const CowVector<Vertex>& MeshData::get_vertices() const {
@@ -23,4 +35,16 @@ void MeshData::set_indices(const CowVector<Index>& indices) {
 	_indices = indices;
 }
 
+std::span<Vertex> MeshData::append_vertices(size_t count) {
+	const size_t offset = _vertices.size();
+	_vertices.resize(offset + count);
+	return _vertices.mutable_span().subspan(offset);
+}
+
+std::span<Index> MeshData::append_indices(size_t count) {
+	const size_t offset = _indices.size();
+	_indices.resize(offset + count);
+	return _indices.mutable_span().subspan(offset);
+}
+
 } //namespace feather
\ No newline at end of file
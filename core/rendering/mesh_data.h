@@ -3,6 +3,8 @@
 #include "framework/cow_vector.h"
 #include <math/math_defs.h>
 #include <array>
+#include <memory_resource>
+#include <span>
 #include <vector>
 
 namespace feather {
@@ -20,6 +22,15 @@ class MeshData {
 	void set_vertices(const CowVector<Vertex>& vertices);
 	void set_indices(const CowVector<Index>& indices);
 
+	// Grow by count elements and return them for writing: one uniqueness check
+	// for the whole range (see CowVector::mutable_span), and the existing
+	// elements are only copied if a renderer still shares the buffer
+	std::span<Vertex> append_vertices(size_t count);
+	std::span<Index> append_indices(size_t count);
+
+	// Pool shared by all long-lived mesh buffers, keeping them off the general heap
+	static std::pmr::memory_resource* get_memory_resource();
+
 protected:
 	CowVector<Vertex> _vertices {};
 	CowVector<Index> _indices {};
@@ -29,14 +29,20 @@ void RenderScene::set_camera_projection(const Projection& projection) {
 }
 
 void RenderScene::add_entity(const EntityRender& entity) {
-	_entities.push_back(entity);
+	if (_entity_cursor == _entities.size()) {
+		_entities.push_back(entity);
+	}
+	else if (!(_entities[_entity_cursor] == entity)) {
+		_entities.set(_entity_cursor, entity);
+	}
+	++_entity_cursor;
 }
 
 void RenderScene::reserve_entities(size_t count) {
 	_entities.reserve(count);
 }
 
-const CowVector<RenderScene::EntityRender>& RenderScene::get_entities() const noexcept {
+const PersistentVector<RenderScene::EntityRender>& RenderScene::get_entities() const noexcept {
 	return _entities;
 }
 
@@ -80,6 +86,21 @@ size_t RenderScene::get_light_count() const noexcept {
 void RenderScene::clear() {
 	_entities.clear();
 	_lights.clear();
+	_entity_cursor = 0;
+}
+
+void RenderScene::begin_update() {
+	_entity_cursor = 0;
+	_lights.clear();
+}
+
+void RenderScene::end_update() {
+	_entities.truncate(_entity_cursor);
+}
+
+void RenderScene::set_memory_resource(std::pmr::memory_resource* resource) {
+	_entities.set_memory_resource(resource);
+	_lights.set_memory_resource(resource);
 }
 
 } //namespace feather
\ No newline at end of file
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "framework/cow_vector.h"
+#include "framework/persistent_vector.h"
 #include "math/projection.h"
 #include "math/transform.h"
 #include "mesh_data.h"
@@ -28,11 +29,13 @@ class RenderScene : public Reflected {
 		uint32_t entity_id = 0; // For debugging/identification
 		bool cast_shadows = true;
 		bool receive_shadows = true;
+
+		bool operator==(const EntityRender&) const = default;
 	};
 
 	RenderScene();
 
-	// With COW vectors, copies are cheap - they just increment ref count
+	// Copies are cheap: entities are structurally shared chunks, lights a COW vector
 	RenderScene(const RenderScene&);
 	RenderScene& operator=(const RenderScene&);
 	RenderScene(RenderScene&&) noexcept;
@@ -48,7 +51,7 @@ class RenderScene : public Reflected {
 	void add_entity(const EntityRender& entity);
 	void reserve_entities(size_t count);
 
-	const CowVector<EntityRender>& get_entities() const noexcept;
+	const PersistentVector<EntityRender>& get_entities() const noexcept;
 	size_t get_entity_count() const noexcept;
 
 	// Light management
@@ -61,6 +64,17 @@ class RenderScene : public Reflected {
 	// Clear for reuse (triggers copy-on-write if shared)
 	void clear();
 
+	// Incremental rebuild: between begin_update() and end_update(), add_entity()
+	// refills the entities in order but leaves one that equals the entity already
+	// at its position untouched, so a scene that barely moved only copies the
+	// chunks holding changed entities away from the snapshots sharing them.
+	// Lights are few and simply rebuilt.
+	void begin_update();
+	void end_update();
+
+	// Entity/light storage is allocated from this resource (null = general heap)
+	void set_memory_resource(std::pmr::memory_resource* resource);
+
 	// Todo will probably move
 	// Environment/Scene settings
 	struct EnvironmentSettings {
@@ -78,7 +92,9 @@ class RenderScene : public Reflected {
 private:
 	Transform _camera_transform;
 	Projection _camera_projection;
-	CowVector<EntityRender> _entities;
+	PersistentVector<EntityRender> _entities;
+	// Position the next add_entity() writes to
+	size_t _entity_cursor = 0;
 	CowVector<Light> _lights;
 	EnvironmentSettings _environment;
 };
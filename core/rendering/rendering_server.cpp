@@ -4,13 +4,17 @@
 #include <main/notification.h>
 #include <resources/shader.h>
 
+#include <framework/alloc_tracker.h>
 #include <framework/assert.h>
+#include <framework/profiler.h>
 #include <framework/variant.h>
 #include <main/class_db.h>
 #include <main/launch_settings.h>
 #include <world/components/light.h>
 #include <framework/static_string.hpp>
 
+#include <iostream>
+#include <span>
 #include <string_view>
 
 namespace feather {
@@ -21,34 +25,21 @@ void RenderingServer::_run() {
 	_render_thread = std::jthread(bind_method(&RenderingServer::_render_function, this));
 }
 
-void RenderingServer::_render_function() {
-	while (true) {
-		bool stop_requested;
-		{
-			std::unique_lock lock(_wait_mutex);
-			_wait_cv.wait(lock, [this] {
-				return _dirty.load(std::memory_order_acquire) || _render_thread.get_stop_token().stop_requested();
-			});
-			_dirty.store(false, std::memory_order_release);
-			stop_requested = _render_thread.get_stop_token().stop_requested();
-		}
-
-		if (stop_requested) {
-			break;
-		}
+void RenderingServer::_render_function(std::stop_token stop) {
+	AllocTagScope tag { AllocTag::rendering };
+	Profiler::set_thread_name("Render");
+	RenderScene frames[2];
+	while (_frames.wait_pop(frames[0], stop)) {
+		FPROFILE_ZONE("RenderingServer::render_frame");
+		// The queue holds two frames, so at most one newer is waiting: draw only the newest
+		const size_t newer = _frames.try_pop_batch(std::span(frames).subspan(1));
+		const RenderScene& scene = frames[newer];
 
 		if (_needs_resize.load(std::memory_order_relaxed)) {
 			_renderer->_on_resize();
 			_needs_resize.store(false, std::memory_order_relaxed);
 		}
 
-		RenderScene scene;
-		{
-			std::lock_guard lock(_write_lock);
-			int read_idx = 1 - _write_idx.load(std::memory_order_relaxed);
-			scene = _buffers[read_idx]; // O(1) COW copy
-		}
-
 		_renderer->_render_scene(scene);
 	}
 }
@@ -56,11 +47,12 @@ void RenderingServer::_render_function() {
 RenderingServer::RenderingServer() {
 	fassert(!_instance);
 	_instance = this;
+
+	_scene.set_memory_resource(&_scene_pool);
 }
 
 RenderingServer::~RenderingServer() {
 	_render_thread.request_stop();
-	_wait_cv.notify_all();
 }
 
 void RenderingServer::init() {
@@ -82,56 +74,88 @@ void RenderingServer::stop() {
 	_render_thread.request_stop();
 	if (_render_thread.joinable())
 		_render_thread.join();
+
+#if BETA
+	const lock_contention_stats& stats = _write_lock.get_stats();
+	std::println(std::cout,
+				 "RenderingServer write lock: {} acquisitions, {} contended, {} spins, {} parks ({} us parked)",
+				 stats.acquisitions.load(),
+				 stats.contended.load(),
+				 stats.spins.load(),
+				 stats.parks.load(),
+				 stats.park_nanoseconds.load() / 1000);
+	const CountingResource::Stats memory = get_scene_memory_stats();
+	std::println(std::cout,
+				 "RenderingServer scene pool: {} upstream allocations, {} KiB reserved",
+				 memory.upstream_allocations,
+				 memory.bytes_reserved / 1024);
+	std::println(std::cout, "RenderingServer: {} committed frames dropped", get_dropped_frame_count());
+#endif
 }
 
 void RenderingServer::begin_scene_frame() {
+	AllocTagScope tag { AllocTag::rendering };
 	std::lock_guard lock(_write_lock);
-	_buffers[_write_idx.load(std::memory_order_relaxed)].clear();
+	_scene.begin_update();
 }
 
 void RenderingServer::set_camera_transform(const Transform& transform) {
 	std::lock_guard lock(_write_lock);
-	_buffers[_write_idx.load(std::memory_order_relaxed)].set_camera_transform(transform);
+	_scene.set_camera_transform(transform);
 }
 
 void RenderingServer::set_camera_projection(const Projection& projection) {
 	std::lock_guard lock(_write_lock);
-	_buffers[_write_idx.load(std::memory_order_relaxed)].set_camera_projection(projection);
+	_scene.set_camera_projection(projection);
 }
 
 void RenderingServer::set_environment(const RenderScene::EnvironmentSettings& env) {
 	std::lock_guard lock(_write_lock);
-	_buffers[_write_idx.load(std::memory_order_relaxed)].set_environment(env);
+	_scene.set_environment(env);
 }
 
 void RenderingServer::add_entity(const RenderScene::EntityRender& entity) {
+	AllocTagScope tag { AllocTag::rendering };
 	std::lock_guard lock(_write_lock);
-	_buffers[_write_idx.load(std::memory_order_relaxed)].add_entity(entity);
+	_scene.add_entity(entity);
 }
 
 void RenderingServer::add_light(const Light& light) {
+	AllocTagScope tag { AllocTag::rendering };
 	std::lock_guard lock(_write_lock);
-	_buffers[_write_idx.load(std::memory_order_relaxed)].add_light(light);
+	_scene.add_light(light);
 }
 
 void RenderingServer::commit_scene_frame() {
+	AllocTagScope tag { AllocTag::rendering };
+	FPROFILE_FUNCTION();
+	RenderScene frame;
 	{
 		std::lock_guard lock(_write_lock);
-		int old_write = _write_idx.load(std::memory_order_relaxed);
-		_write_idx.store(1 - old_write, std::memory_order_release);
-		_dirty.store(true, std::memory_order_release);
+		_scene.end_update();
+		frame = _scene; // O(1) structural-sharing copy
 	}
 
 	if (LaunchSettings::get().force_single_thread.Get()) {
-		int read_idx = 1 - _write_idx.load(std::memory_order_acquire);
-		_renderer->_render_scene(_buffers[read_idx]);
-		_dirty.store(false, std::memory_order_relaxed);
+		_renderer->_render_scene(frame);
 	}
 	else {
-		_wait_cv.notify_one();
+		// Full when the render thread hasn't picked up the last two commits yet.
+		// The producer can't evict from an SPSC queue, so this frame is dropped
+		// and counted; the render thread draws the newer of the two it has.
+		if (!_frames.try_push(std::move(frame)))
+			_dropped_frames.fetch_add(1, std::memory_order_relaxed);
 	}
 }
 
+CountingResource::Stats RenderingServer::get_scene_memory_stats() const {
+	return _scene_upstream.get_stats();
+}
+
+uint64_t RenderingServer::get_dropped_frame_count() const {
+	return _dropped_frames.load(std::memory_order_relaxed);
+}
+
 void RenderingServer::use_renderer(std::string_view name) {
 	_renderer = ClassDB::create_object<Renderer>(name);
 	fassert(_renderer.get(), std::format("Failed to create renderer of type {}", name));
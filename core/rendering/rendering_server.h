@@ -1,5 +1,7 @@
 #pragma once
 
+#include "framework/linear_arena.h"
+#include "framework/ring_queue.h"
 #include "framework/spinlock.h"
 #include "main/launch_settings.h"
 #include "render_scene.h"
@@ -7,11 +9,11 @@
 
 #include <main/engine_settings.h>
 
-#include <array>
 #include <atomic>
-#include <condition_variable>
 #include <memory>
+#include <memory_resource>
 #include <mutex>
+#include <stop_token>
 #include <thread>
 
 namespace feather {
@@ -24,17 +26,30 @@ class RenderingServer {
 
 	std::unique_ptr<Renderer> _renderer = nullptr;
 
-	std::array<RenderScene, 2> _buffers;
-	std::atomic<int> _write_idx { 0 };
-	std::atomic<bool> _dirty { false };
-	spinlock _write_lock;
-	std::mutex _wait_mutex;
-	std::condition_variable _wait_cv;
+	// Backs the scene chunks; synchronized since the render thread may drop the
+	// last reference to a chunk. Declared first so it outlives the scenes. Once
+	// the pool has grown to the scene's size, its upstream sees no more traffic.
+	CountingResource _scene_upstream;
+	std::pmr::synchronized_pool_resource _scene_pool { &_scene_upstream };
+	// Persistent scene updated in place by the simulation, and the committed
+	// snapshots of it on their way to the render thread. Publishing is an O(1)
+	// copy; snapshots share every chunk that did not change in between.
+	RenderScene _scene;
+	// Two slots: the frame being picked up and the one committed after it
+	SpscQueue<RenderScene> _frames { 2 };
+	// Commits that found _frames full and were never rendered
+	std::atomic<uint64_t> _dropped_frames { 0 };
+	// Taken for every change to _scene, possibly from several simulation threads
+#if BETA
+	adaptive_lock<true> _write_lock;
+#else
+	adaptive_lock<> _write_lock;
+#endif
 
 	std::jthread _render_thread;
 
 	void _run();
-	void _render_function();
+	void _render_function(std::stop_token stop);
 
 	std::atomic<bool> _needs_resize { false };
 
@@ -56,6 +71,12 @@ class RenderingServer {
 	void add_light(const Light& light);
 	void commit_scene_frame();
 
+	// What the scene pool took from the general heap; an upstream_allocations
+	// count that stays put across frames means scene updates no longer touch it
+	CountingResource::Stats get_scene_memory_stats() const;
+	// Committed frames the render thread never saw because it was two behind
+	uint64_t get_dropped_frame_count() const;
+
 	template <class T> void use_renderer() { _renderer = std::make_unique<T>(); }
 	void use_renderer(std::string_view name);
 
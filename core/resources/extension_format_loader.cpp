@@ -1,6 +1,7 @@
 #include "extension_format_loader.h"
 #include "extension.h"
 #include <framework/shared_library.h>
+#include <main/class_db.h>
 #include <iostream>
 
 namespace feather {
@@ -38,7 +39,11 @@ void ExtensionFormatLoader::load(std::shared_ptr<Resource> resource, const Path&
 	auto ext = std::static_pointer_cast<Extension>(resource);
 	Callable entry_fn = ext->_library_handle->get_symbol(ext->get_entry_point());
 	if (entry_fn.is_valid()) {
-		entry_fn.call();
+		{
+			// Whatever classes the extension registers are numbered in one pass
+			ClassDB::RegistrationBatch batch;
+			entry_fn.call();
+		}
 		std::println(std::cout, "ExtensionFormatLoader: Loaded extension '{}' from {}", ext->get_name(), path.string());
 	}
 	else {
@@ -47,4 +52,9 @@ void ExtensionFormatLoader::load(std::shared_ptr<Resource> resource, const Path&
 	}
 }
 
+Task<> ExtensionFormatLoader::load_async(std::shared_ptr<Resource> resource, Path path) {
+	load(std::move(resource), path);
+	co_return;
+}
+
 } // namespace feather
@@ -14,6 +14,8 @@ class ExtensionFormatLoader : public ResourceFormatLoader {
 protected:
 	std::shared_ptr<Resource> instantiate(const Path& path) override;
 	void load(std::shared_ptr<Resource> resource, const Path& path) override;
+	// Entry points register classes and expect the main thread: no job hop
+	Task<> load_async(std::shared_ptr<Resource> resource, Path path) override;
 	bool requires_immediate_load() const override { return true; }
 
 public:
@@ -1,12 +1,13 @@
 #include "mesh.h"
 
 #include "framework/container_utils.h"
-#include "framework/variant_array.h"
+#include "framework/packed_arrays.h"
 #include "math/math_defs.h"
 #include "rendering/mesh_data.h"
 #include <core/framework/variant.h>
 #include <core/main/class_db.h>
 #include <framework/reflection_macros.h>
+#include <algorithm>
 #include <set>
 #include <vector>
 
@@ -27,50 +28,43 @@ void Mesh::set_indices(const CowVector<Index>& indices) {
 	}
 }
 
-void ComplexMesh::add_vertices(const VariantArray vertices) {
-	CowVector<Vertex> raw_vertices;
-	if (_mesh_data) {
-		raw_vertices = _mesh_data->get_vertices();
+void ComplexMesh::add_vertices(const PackedVertexArray vertices) {
+	if (!_mesh_data) {
+		_mesh_data = std::make_shared<MeshData>();
 	}
-	raw_vertices.reserve(raw_vertices.size() + vertices.size());
-	for (const auto& v : vertices) {
-		if (v.is_type(VariantType::VERTEX)) {
-			raw_vertices.push_back(v.as<Vertex>().value());
-		}
+
+	if (_mesh_data->get_vertices().empty()) {
+		_mesh_data->set_vertices(vertices);
+		return;
 	}
 
-	_mesh_data->set_vertices(raw_vertices);
+	std::ranges::copy(vertices, _mesh_data->append_vertices(vertices.size()).begin());
 }
 
-void ComplexMesh::add_indices(const VariantArray indices) {
-	CowVector<uint32_t> raw_indices;
-	if (_mesh_data) {
-		raw_indices = _mesh_data->get_indices();
-	}
-	raw_indices.reserve(raw_indices.size() + indices.size());
-	for (const auto& v : indices) {
-		if (v.is_type(VariantType::INT)) {
-			raw_indices.push_back(v.as<int>().value());
-		}
+void ComplexMesh::add_indices(const PackedInt32Array indices) {
+	if (!_mesh_data) {
+		_mesh_data = std::make_shared<MeshData>();
 	}
 
-	_mesh_data->set_indices(raw_indices);
+	// Index is unsigned, so this is a plain widening copy rather than a buffer adoption
+	std::ranges::copy(indices, _mesh_data->append_indices(indices.size()).begin());
 }
 
 void ComplexMesh::set_mesh_data(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices) {
 	_mesh_data = std::make_shared<MeshData>(vertices, indices);
 }
 
-VariantArray ComplexMesh::get_vertices() const {
+PackedVertexArray ComplexMesh::get_vertices() const {
 	if (!_mesh_data)
-		return VariantArray();
-	return { _mesh_data->get_vertices().begin(), _mesh_data->get_vertices().end() };
+		return PackedVertexArray();
+	return _mesh_data->get_vertices();
 }
 
-VariantArray ComplexMesh::get_indices() const {
+PackedInt32Array ComplexMesh::get_indices() const {
 	if (!_mesh_data)
-		return VariantArray();
-	return { _mesh_data->get_indices().begin(), _mesh_data->get_indices().end() };
+		return PackedInt32Array();
+	const CowVector<Index>& indices = _mesh_data->get_indices();
+	return PackedInt32Array(indices.begin(), indices.end());
 }
 
 //// Box Mesh ////
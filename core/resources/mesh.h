@@ -1,6 +1,6 @@
 #pragma once
 
-#include "framework/variant_array.h"
+#include "framework/packed_arrays.h"
 #include "math/math_defs.h"
 #include "resource.h"
 #include <core/framework/reflection_macros.h>
@@ -39,15 +39,17 @@ class ComplexMesh : public Mesh {
 public:
 	ComplexMesh() = default;
 
+	// Vertices are adopted without copying when the mesh has none yet
 	[[method]]
-	void add_vertices(const VariantArray vertices);
+	void add_vertices(const PackedVertexArray vertices);
 	[[method]]
-	void add_indices(const VariantArray indices);
+	void add_indices(const PackedInt32Array indices);
 
+	// Shares the mesh's vertex buffer
 	[[method]]
-	VariantArray get_vertices() const;
+	PackedVertexArray get_vertices() const;
 	[[method]]
-	VariantArray get_indices() const;
+	PackedInt32Array get_indices() const;
 
 	void set_mesh_data(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
 };
@@ -2,6 +2,9 @@
 
 #include "mesh.h"
 
+#include <framework/alloc_tracker.h>
+#include <framework/io_executor.h>
+
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 #include <assimp/Importer.hpp>
@@ -24,16 +27,16 @@ std::shared_ptr<Resource> MeshFormatLoader::instantiate(const Path& path) {
 	return mesh;
 }
 
-void MeshFormatLoader::load(std::shared_ptr<Resource> resource, const Path& path) {
-	const aiScene* scene = _importer->ReadFile(path.string(),
-											   aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs |
-													   aiProcess_CalcTangentSpace);
+namespace {
 
-	if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-		std::cerr << "Assimp error: " << _importer->GetErrorString() << std::endl;
-		return;
-	}
+constexpr unsigned int import_flags =
+		aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace;
 
+bool is_complete(const aiScene* scene) {
+	return scene && !(scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) && scene->mRootNode;
+}
+
+void fill_mesh(const aiScene* scene, ComplexMesh& target) {
 	std::vector<Vertex> vertices;
 	std::vector<uint32_t> indices;
 
@@ -64,7 +67,52 @@ void MeshFormatLoader::load(std::shared_ptr<Resource> resource, const Path& path
 		}
 	}
 
-	std::static_pointer_cast<ComplexMesh>(resource)->set_mesh_data(vertices, indices);
+	target.set_mesh_data(vertices, indices);
+}
+
+} // namespace
+
+void MeshFormatLoader::load(std::shared_ptr<Resource> resource, const Path& path) {
+	const aiScene* scene = _importer->ReadFile(path.string(), import_flags);
+
+	if (!is_complete(scene)) {
+		std::cerr << "Assimp error: " << _importer->GetErrorString() << std::endl;
+		return;
+	}
+
+	fill_mesh(scene, *std::static_pointer_cast<ComplexMesh>(resource));
+}
+
+Task<> MeshFormatLoader::load_async(std::shared_ptr<Resource> resource, Path path) {
+	// Either way the rest runs as a job, so decoding overlaps the other reads in flight
+	std::optional<std::vector<std::byte>> bytes;
+	if (IoExecutor* io = IoExecutor::get())
+		bytes = co_await io->read_file(path);
+	else if (JobSystem* jobs = JobSystem::get())
+		co_await resume_on(*jobs);
+
+	// After the last co_await, so the scope stays on one thread
+	AllocTagScope tag { AllocTag::resources };
+
+	// _importer isn't thread-safe, so each async load gets its own
+	Assimp::Importer importer;
+	const aiScene* scene = nullptr;
+	if (bytes) {
+		std::string extension = path.extension().string();
+		if (!extension.empty())
+			extension.erase(0, 1);
+		scene = importer.ReadFileFromMemory(bytes->data(), bytes->size(), import_flags, extension.c_str());
+	}
+	// Formats referencing other files (.gltf buffers, .obj materials...) need the path
+	if (!is_complete(scene))
+		scene = importer.ReadFile(path.string(), import_flags);
+
+	if (!is_complete(scene)) {
+		std::cerr << "Assimp error: " << importer.GetErrorString() << std::endl;
+		co_return;
+	}
+
+	fill_mesh(scene, *std::static_pointer_cast<ComplexMesh>(resource));
 }
 
 } // namespace feather
\ No newline at end of file
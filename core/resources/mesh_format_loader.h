@@ -22,6 +22,7 @@ class MeshFormatLoader : public ResourceFormatLoader {
 protected:
 	std::shared_ptr<Resource> instantiate(const Path& path) override;
 	void load(std::shared_ptr<Resource> resource, const Path& path) override;
+	Task<> load_async(std::shared_ptr<Resource> resource, Path path) override;
 
 public:
 	MeshFormatLoader();
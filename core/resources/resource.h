@@ -4,6 +4,8 @@
 #include <core/framework/reflected.h>
 #include <core/framework/reflection_macros.h>
 
+#include <atomic>
+
 #ifndef FEATHER_REFLECTION_PARSER
 #include "resource.gen.h"
 #endif
@@ -32,7 +34,11 @@ class Resource : public Reflected {
 		return _rid;
 	};
 
-	virtual bool is_loaded() { return false; };
+	// Set by ResourceLoader once a load has filled the resource (or registered it)
+	virtual bool is_loaded() { return _loaded.load(std::memory_order_acquire); };
+
+private:
+	std::atomic<bool> _loaded { false };
 };
 
 } // namespace feather
\ No newline at end of file
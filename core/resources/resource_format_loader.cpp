@@ -2,5 +2,15 @@
 
 #include "resource_loader.h"
 #include <core/main/class_db.h>
+#include <framework/alloc_tracker.h>
 
-namespace feather {} // namespace feather
+namespace feather {
+
+Task<> ResourceFormatLoader::load_async(std::shared_ptr<Resource> resource, Path path) {
+	if (JobSystem* jobs = JobSystem::get())
+		co_await resume_on(*jobs);
+	AllocTagScope tag { AllocTag::resources };
+	load(std::move(resource), path);
+}
+
+} // namespace feather
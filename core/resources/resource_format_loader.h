@@ -4,6 +4,7 @@
 #include <core/framework/path.h>
 #include <framework/reflected.h>
 #include <framework/reflection_macros.h>
+#include <framework/task.h>
 
 #include <string>
 
@@ -26,6 +27,11 @@ class ResourceFormatLoader : public Reflected {
 	// Fill data into an existing resource instance (called after instantiate, or for reload)
 	virtual void load(std::shared_ptr<Resource> resource, const Path& path) = 0;
 
+	// Async variant of load, driven by ResourceLoader::load_async. The default
+	// runs load() as a job; loaders can override it to await their reads on the
+	// IoExecutor instead, so reading one file overlaps decoding another.
+	virtual Task<> load_async(std::shared_ptr<Resource> resource, Path path);
+
 	// If true, index_project calls load() immediately after instantiate
 	virtual bool requires_immediate_load() const { return false; }
 
@@ -1,10 +1,12 @@
 #include "resource_loader.h"
 
 #include <core/main/class_db.h>
+#include <framework/alloc_tracker.h>
 #include <main/project_settings.h>
 #include <algorithm>
 #include <filesystem>
 #include <iostream>
+#include <thread>
 
 namespace feather {
 
@@ -28,7 +30,10 @@ RID ResourceLoader::generate_rid() {
 
 void ResourceLoader::register_resource(std::shared_ptr<Resource> res) {
 	res->_rid = generate_rid();
-	get()->_cache[res->_rid] = res;
+	res->_loaded.store(true, std::memory_order_release);
+	auto& self = *get();
+	std::lock_guard lock(self._mutex);
+	self._cache[res->_rid] = res;
 }
 
 static std::string strip_extension(const Path& path) {
@@ -38,44 +43,144 @@ static std::string strip_extension(const Path& path) {
 	return ext;
 }
 
-std::shared_ptr<Resource> ResourceLoader::load(const Path& path) {
+ResourceFormatLoader* ResourceLoader::_find_loader(const std::string& extension) const {
+	for (const auto& loader : _format_loaders) {
+		if (loader->recognize_extension(extension))
+			return loader.get();
+	}
+	return nullptr;
+}
+
+void ResourceLoader::PendingLoad::finish() {
+	std::vector<std::coroutine_handle<>> resume;
+	{
+		std::lock_guard lock(mutex);
+		done.store(true, std::memory_order_release);
+		resume.swap(waiters);
+	}
+	for (std::coroutine_handle<> waiter : resume) {
+		if (JobSystem* jobs = JobSystem::get())
+			jobs->post([waiter] { waiter.resume(); });
+		else
+			waiter.resume();
+	}
+}
+
+ResourceLoader::LoadPlan ResourceLoader::_plan_load(const Path& path, const Path& localized) {
+	std::lock_guard lock(_mutex);
+
+	if (auto pending = _in_flight.find(path.string()); pending != _in_flight.end())
+		return { .pending = pending->second };
+
 	auto extension = strip_extension(path);
+
+	std::shared_ptr<Resource> res;
+	if (auto it = _path_cache.find(path.string()); it != _path_cache.end()) {
+		// Indexed by index_project but not loaded yet
+		res = it->second;
+		if (res->is_loaded())
+			return { .resource = res };
+	}
+	else if (extension.empty()) {
+		std::cerr << "ResourceLoader: Cannot load resource without extension: " << path << std::endl;
+		return {};
+	}
+
+	ResourceFormatLoader* loader = _find_loader(extension);
+	if (!loader) {
+		if (!res)
+			std::cerr << "ResourceLoader: No loader for extension '" << extension << "' for resource: " << path << std::endl;
+		return { .resource = res };
+	}
+
+	if (!res) {
+		res = loader->instantiate(localized);
+		if (!res)
+			return {};
+		res->_rid = generate_rid();
+	}
+
+	auto pending = std::make_shared<PendingLoad>();
+	pending->resource = res;
+	_in_flight.emplace(path.string(), pending);
+	return { .pending = std::move(pending), .loader = loader };
+}
+
+void ResourceLoader::_finish_load(const Path& path, PendingLoad& pending) {
+	{
+		std::lock_guard lock(_mutex);
+		_in_flight.erase(path.string());
+		pending.resource->_loaded.store(true, std::memory_order_release);
+		_cache.try_emplace(pending.resource->_rid, pending.resource);
+		_path_cache.try_emplace(path.string(), pending.resource);
+	}
+	pending.finish();
+}
+
+void ResourceLoader::_wait_for(PendingLoad& pending) {
+	if (JobSystem* jobs = JobSystem::get()) {
+		jobs->wait_until([&pending] { return pending.done.load(std::memory_order_acquire); });
+	}
+	else {
+		while (!pending.done.load(std::memory_order_acquire)) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+std::shared_ptr<Resource> ResourceLoader::load(const Path& path) {
+	AllocTagScope tag { AllocTag::resources };
 	auto localized = ProjectSettings::get()->localize_path(path);
 
-	auto it = get()->_path_cache.find(path.string());
-	if (it != get()->_path_cache.end()) {
-		auto res = it->second;
-		if (!res->is_loaded()) {
-			for (const auto& loader : get()->_format_loaders) {
-				if (loader->recognize_extension(extension)) {
-					loader->load(res, localized);
-					break;
-				}
-			}
+	auto& self = *get();
+	LoadPlan plan = self._plan_load(path, localized);
+	if (!plan.pending)
+		return plan.resource;
+
+	if (plan.loader) {
+		// Whatever happens, callers waiting on the same path must be let go
+		try {
+			plan.loader->load(plan.pending->resource, localized);
+		}
+		catch (...) {
+			self._finish_load(path, *plan.pending);
+			throw;
 		}
-		return res;
+		self._finish_load(path, *plan.pending);
+	}
+	else {
+		_wait_for(*plan.pending);
 	}
+	return plan.pending->resource;
+}
 
-	if (extension.empty()) {
-		std::cerr << "ResourceLoader: Cannot load resource without extension: " << path << std::endl;
-		return nullptr;
+Task<std::shared_ptr<Resource>> ResourceLoader::load_async(Path path) {
+	auto& self = *get();
+	Path localized;
+	LoadPlan plan;
+	{
+		// Not kept across the co_awaits below: the coroutine may resume elsewhere
+		AllocTagScope tag { AllocTag::resources };
+		localized = ProjectSettings::get()->localize_path(path);
+		plan = self._plan_load(path, localized);
 	}
+	if (!plan.pending)
+		co_return plan.resource;
 
-	for (const auto& loader : get()->_format_loaders) {
-		if (loader->recognize_extension(extension)) {
-			auto res = loader->instantiate(localized);
-			if (!res)
-				return nullptr;
-			res->_rid = generate_rid();
-			get()->_cache[res->_rid] = res;
-			get()->_path_cache[path.string()] = res;
-			loader->load(res, localized);
-			return res;
+	if (plan.loader) {
+		try {
+			co_await plan.loader->load_async(plan.pending->resource, localized);
 		}
+		catch (...) {
+			self._finish_load(path, *plan.pending);
+			throw;
+		}
+		self._finish_load(path, *plan.pending);
 	}
-
-	std::cerr << "ResourceLoader: No loader for extension '" << extension << "' for resource: " << path << std::endl;
-	return nullptr;
+	else {
+		co_await *plan.pending;
+	}
+	co_return plan.pending->resource;
 }
 
 void ResourceLoader::add_resource_format_loader(std::shared_ptr<ResourceFormatLoader> loader) {
@@ -91,6 +196,7 @@ void ResourceLoader::remove_resource_format_loader(std::shared_ptr<ResourceForma
 }
 
 void ResourceLoader::index_project() {
+	AllocTagScope tag { AllocTag::resources };
 	auto project_path = ProjectSettings::get()->get_project_path();
 	if (project_path.empty() || !std::filesystem::exists(project_path))
 		return;
@@ -103,8 +209,11 @@ void ResourceLoader::index_project() {
 			continue;
 
 		Path path = entry.path();
-		if (self._path_cache.contains(path.string()))
-			continue;
+		{
+			std::lock_guard lock(self._mutex);
+			if (self._path_cache.contains(path.string()) || self._in_flight.contains(path.string()))
+				continue;
+		}
 
 		auto extension = strip_extension(path);
 
@@ -117,13 +226,16 @@ void ResourceLoader::index_project() {
 				break; // loader explicitly declined (e.g. DLL without _load_extension)
 
 			res->_rid = generate_rid();
-			self._cache[res->_rid] = res;
-			self._path_cache[path.string()] = res;
-			++count;
-
 			if (loader->requires_immediate_load()) {
 				loader->load(res, path);
+				res->_loaded.store(true, std::memory_order_release);
+			}
+			{
+				std::lock_guard lock(self._mutex);
+				self._cache[res->_rid] = res;
+				self._path_cache[path.string()] = res;
 			}
+			++count;
 			break;
 		}
 	}
@@ -6,8 +6,15 @@
 
 #include <framework/reflected.h>
 #include <framework/reflection_macros.h>
+#include <framework/task.h>
 
 #include <atomic>
+#include <coroutine>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #ifndef FEATHER_REFLECTION_PARSER
 #include "resource_loader.gen.h"
@@ -18,12 +25,59 @@ namespace feather {
 class ResourceLoader : public Reflected {
 	FCLASS(singleton);
 
+	// A load in progress. Other callers asking for the same path meanwhile wait
+	// for it rather than loading again; co_await it or poll done.
+	struct PendingLoad {
+		std::shared_ptr<Resource> resource;
+		std::atomic<bool> done { false };
+		std::mutex mutex;
+		std::vector<std::coroutine_handle<>> waiters;
+
+		auto operator co_await() noexcept {
+			struct Awaiter {
+				PendingLoad& load;
+
+				bool await_ready() const noexcept { return load.done.load(std::memory_order_acquire); }
+				bool await_suspend(std::coroutine_handle<> handle) {
+					std::lock_guard lock(load.mutex);
+					if (load.done.load(std::memory_order_relaxed))
+						return false;
+					load.waiters.push_back(handle);
+					return true;
+				}
+				void await_resume() const noexcept {}
+			};
+			return Awaiter { *this };
+		}
+
+		// Marks the load done and resumes the waiters (as jobs when there is a JobSystem)
+		void finish();
+	};
+
+	// What a call to load(path) has to do. Either resource is ready (or null on
+	// failure), or pending is set: this caller loads it through loader, or, with
+	// loader null, waits for the caller that does.
+	struct LoadPlan {
+		std::shared_ptr<Resource> resource;
+		std::shared_ptr<PendingLoad> pending;
+		ResourceFormatLoader* loader = nullptr;
+	};
+
 	std::atomic<size_t> m_counter { 1 };
 
+	// Guards the caches and _in_flight: loads finish on job workers
+	std::mutex _mutex;
 	std::unordered_map<RID, std::shared_ptr<Resource>> _cache;
 	std::unordered_map<std::string, std::shared_ptr<Resource>> _path_cache;
+	std::unordered_map<std::string, std::shared_ptr<PendingLoad>> _in_flight;
 	std::vector<std::shared_ptr<ResourceFormatLoader>> _format_loaders;
 
+	ResourceFormatLoader* _find_loader(const std::string& extension) const;
+	// A new resource is only added to the caches by _finish_load, once filled
+	LoadPlan _plan_load(const Path& path, const Path& localized);
+	void _finish_load(const Path& path, PendingLoad& pending);
+	static void _wait_for(PendingLoad& pending);
+
 public:
 	ResourceLoader();
 
@@ -40,6 +94,17 @@ class ResourceLoader : public Reflected {
 		return std::static_pointer_cast<T>(ptr);
 	}
 
+	// The loading itself runs off the calling thread (see
+	// ResourceFormatLoader::load_async). Loads of a path already being loaded,
+	// sync or async, wait for that one and return the same resource. Without job
+	// workers, a thread polling the task must run queued jobs meanwhile (see
+	// JobSystem::run_pending).
+	Task<std::shared_ptr<Resource>> load_async(Path path);
+	template <std::derived_from<Resource> T>
+	Task<std::shared_ptr<T>> load_async(Path path) {
+		co_return std::static_pointer_cast<T>(co_await load_async(std::move(path)));
+	}
+
 	void add_resource_format_loader(std::shared_ptr<ResourceFormatLoader> loader);
 	void remove_resource_format_loader(std::shared_ptr<ResourceFormatLoader> loader);
 
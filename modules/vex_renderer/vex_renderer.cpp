@@ -12,6 +12,7 @@
 #include <core/world/components/light.h>
 #include <framework/assert.h>
 #include <framework/bytes.h>
+#include <framework/profiler.h>
 
 #include <raw_resources/shaders/depth_prepass.slang.gen.h>
 #include <raw_resources/shaders/pbr_forward.slang.gen.h>
@@ -193,6 +194,8 @@ VexRenderer::VexRenderer()
 }
 
 void VexRenderer::_render_scene(const RenderScene capture) {
+	_frame_arena.begin_frame();
+
 	auto ctx = graphics.CreateCommandContext(vex::QueueType::Graphics);
 	// Upload camera uniforms
 	_upload_camera_uniforms(capture, ctx);
@@ -207,22 +210,31 @@ void VexRenderer::_render_scene(const RenderScene capture) {
 	}
 
 	{
+		FPROFILE_ZONE("Depth Pre-Pass");
 		VEX_GPU_SCOPED_EVENT(ctx, "Depth Pre-Pass");
 		_render_depth_pre_pass(capture, ctx);
 	}
 
 	if (hasShadows) {
+		FPROFILE_ZONE("Shadow Pass");
 		VEX_GPU_SCOPED_EVENT(ctx, "Shadow Pass");
 		_render_shadow_pass(capture, ctx);
 	}
 
 	{
+		FPROFILE_ZONE("Forward Pass");
 		VEX_GPU_SCOPED_EVENT(ctx, "Forward Pass");
 		_render_forward_pass(capture, ctx);
 	}
 
-	graphics.Submit(ctx);
-	graphics.Present();
+	{
+		FPROFILE_ZONE("Submit");
+		graphics.Submit(ctx);
+	}
+	{
+		FPROFILE_ZONE("Present");
+		graphics.Present();
+	}
 }
 
 void VexRenderer::_on_resize() {
@@ -604,7 +616,10 @@ void VexRenderer::_render_forward_pass(const RenderScene& capture, vex::CommandC
 
 		ctx.EnqueueDataUpload(_material_buffer, to_bytes(materialData));
 
-		std::vector<ResourceBinding> tracked_bindings;
+		// Per-entity containers reuse the same scratch memory every iteration
+		ScratchScope scratch;
+		ArenaVector<ResourceBinding> tracked_bindings { scratch.allocator<ResourceBinding>() };
+		tracked_bindings.reserve(_shadow_maps.size() + 4);
 		for (auto& shadowMap : _shadow_maps) {
 			tracked_bindings.push_back(
 					TextureBinding { .texture = shadowMap, .usage = TextureBindingUsage::ShaderRead });
@@ -634,8 +649,9 @@ void VexRenderer::_render_forward_pass(const RenderScene& capture, vex::CommandC
 
 		std::vector<BindlessHandle> handles = graphics.GetBindlessHandles(bindings);
 		tracked_bindings.append_range(bindings);
-		std::vector<uint32_t> push_data(handles.size());
-		std::copy_n(reinterpret_cast<uint32_t*>(handles.data()), handles.size(), push_data.begin());
+		ArenaVector<uint32_t> push_data { scratch.allocator<uint32_t>() };
+		push_data.reserve(handles.size() + 1);
+		push_data.append_range(std::span(reinterpret_cast<const uint32_t*>(handles.data()), handles.size()));
 		push_data.push_back(capture.get_light_count());
 
 		ConstantBinding constant_bindings { std::span(push_data) };
@@ -671,9 +687,11 @@ void VexRenderer::_upload_camera_uniforms(const RenderScene& capture, vex::Comma
 }
 
 void VexRenderer::_upload_lights_buffer(const RenderScene& capture, vex::CommandContext& ctx) {
+	FPROFILE_FUNCTION();
 	const auto& lights = capture.get_lights();
 
-	std::vector<LightBufferData> gpuLights;
+	ArenaVector<LightBufferData> gpuLights { _frame_arena.allocator<LightBufferData>() };
+	gpuLights.reserve(lights.size());
 	for (size_t i = 0; i < lights.size(); ++i) {
 		const auto& light = lights[i];
 		LightBufferData gpuLight {};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <core/framework/linear_arena.h>
 #include <core/framework/reflection_macros.h>
 #include <core/math/math_defs.h>
 #include <core/rendering/render_scene.h>
@@ -39,6 +40,9 @@ class VexRenderer : public Renderer {
 	vex::Buffer _per_entity_uniform_buffer;
 	vex::Buffer _material_buffer;
 
+	// Per-frame CPU-side data (light arrays, ...), one arena per frame in flight
+	FrameArena _frame_arena;
+
 	// Resource caches
 	struct MeshBuffers {
 		vex::Buffer vertex_buffer;
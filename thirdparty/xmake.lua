@@ -9,10 +9,12 @@ if is_mode("debug") then
     add_requireconfs("*", {debug = true})
 end
 
+-- FLECS_PERF_TRACE makes Flecs report systems and pipeline steps to the
+-- profiler (see WorldSim's perf_trace hooks); a no-op while nothing listens.
 add_requires("flecs 4.1.5", {
     system = false,
     alias  = "flecs",
-    configs = {shared = not has_config("static_deps")},
+    configs = {shared = not has_config("static_deps"), cflags = "-DFLECS_PERF_TRACE"},
 })
 
 -- Local package (packages/assimp.lua) builds assimp's bundled minizip instead of
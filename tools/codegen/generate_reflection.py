@@ -711,11 +711,13 @@ def _plan_accessor(plan: PropertyPlan, which: str, arg, member_access: str, cond
     `ref` makes a generated accessor pass/return by const-reference instead of
     by-value (getter returns `const T&`, setter takes `const T&` and
     copy-assigns rather than std::move()s). Only const-ref is supported, not
-    mutable T&: the getter must be `const` (bind_property_get(_if_bindable)
-    requires it, so it could never actually return a mutable reference), and
-    the setter call site in class_db.inl passes `std::move(result.value())`,
-    which won't bind to a non-const T& parameter. Both are real compile
-    errors, so `ref` unconditionally means const-ref."""
+    mutable T&: the generated getter is a `const` member function, which can't
+    hand out a mutable reference to the member, and a `T&` setter parameter
+    wouldn't bind the temporaries callers pass. Generated accessors are C++ API
+    only -- the property descriptor points at the data member itself (see
+    _accessor_pointer()) -- whereas a manual accessor is bound as-is, and its
+    setter receives `value.get_unchecked<U>()`, a const lvalue, so it must take
+    its argument by value or const-ref too."""
     prop, member, ty = plan.prop_name, plan.member_name, plan.type_spelling
 
     def err(msg: str):
@@ -773,15 +775,17 @@ def _handle_method(cls: ClassDesc, info: dict, access: str, condition: str, offs
     forced = "method" in attrs
     if not forced:
         return
-    # bind_method dispatches through object_cast<T>(Reflected*), which a
-    # vtable-free value type has no way to support; a static method is fine.
+    # A bound method is called on a Reflected* whose class is checked through
+    # the virtual get_class_info(), which a vtable-free value type has no way
+    # to support; a static method is fine.
     if cls.is_value_type and not info["is_static"]:
         raise ParseError(
             f"{header}: class {cls.name} method '{name}' near line "
             f"{_line_of(body, offset) + fclass_line - 1}: [[method]] on a non-static method of a "
-            f"value type (FSTRUCT / FCLASS(novtable)) can't be bound -- ClassDB::bind_method "
-            f"dispatches through object_cast<T>(Reflected*), which a vtable-free type has no way "
-            f"to support. Make the method static, or drop 'novtable'/use FCLASS instead."
+            f"value type (FSTRUCT / FCLASS(novtable)) can't be bound -- a bound method is called "
+            f"on a Reflected* whose class is checked through the virtual get_class_info(), which a "
+            f"vtable-free type has no way to support. Make the method static, or drop "
+            f"'novtable'/use FCLASS instead."
         )
     # Skip overloaded names (&T::name is ambiguous) unless every other
     # same-named occurrence is provably in a mutually exclusive #if branch of
@@ -880,6 +884,9 @@ def generate_gen_header(classes: list, header: Path, project_root: Path, registr
             body.append("\tbool is_of_type(StaticString type_name) const override "
                         "{ return get_class_static() == type_name || Super::is_of_type(type_name); }")
             body.append("\tvirtual StaticString get_class_name() override { return get_class_static(); }")
+            # Backs object_cast's class-ID range check (see ClassInfo::is_a)
+            body.append("\tstatic const ClassInfo* get_class_info_static() { return ClassDB::get_class_info<Type>(); }")
+            body.append("\tconst ClassInfo* get_class_info() const override { return get_class_info_static(); }")
         body.extend(public_lines)
         body.append("protected:")
         body.append(f"\tusing Type = {c.name};")
@@ -924,41 +931,73 @@ def generate_gen_header(classes: list, header: Path, project_root: Path, registr
     return "\n".join(lines) + "\n"
 
 
-def _bind_members_body(c: ClassDesc, dir_name: str) -> list:
-    # Unlike the .gen.h macro, this is a real function body -- #if/#endif can
-    # wrap a conditional binding call directly, no hoisted-helper-macro
-    # indirection needed.
-    def emit(out: list, condition: str, stmt: str):
-        if condition:
-            out.append(f"#if {condition}")
-            out.append(stmt)
+def _accessor_pointer(c: ClassDesc, p: PropertyPlan, which: str) -> str:
+    """Template argument for ClassDB::describe_property. A generated accessor
+    only forwards to the member, so the descriptor points at the member itself
+    (its offset, in effect) and skips the call; a manual accessor is bound as-is."""
+    kind = p.getter_kind if which == "get" else p.setter_kind
+    if kind == "none":
+        return "nullptr"
+    if kind == "generate":
+        return f"&{c.name}::{p.member_name}"
+    return f"&{c.name}::{p.getter_method if which == 'get' else p.setter_method}"
+
+
+def _descriptor_array(out: list, element: str, var: str, entries: list) -> bool:
+    """Emit `static constexpr ClassInfo::<element> <var>[]` from [(condition, expr)].
+    A C++ array can't be empty, so when every entry is conditional the array is
+    guarded by the union of their conditions, with an empty span as the
+    fallback. Returns whether <var> was declared at all."""
+    if not entries:
+        return False
+    guard = None
+    if all(cond for cond, _expr in entries):
+        conds = list(dict.fromkeys(cond for cond, _expr in entries))
+        guard = " || ".join(f"({cond})" for cond in conds)
+        out.append(f"#if {guard}")
+    out.append(f"\tstatic constexpr ClassInfo::{element} {var}[] = {{")
+    for cond, expr in entries:
+        if cond:
+            out.append(f"#if {cond}")
+            out.append(f"\t\t{expr},")
             out.append("#endif")
         else:
-            out.append(stmt)
+            out.append(f"\t\t{expr},")
+    out.append("\t};")
+    if guard:
+        out.append("#else")
+        out.append(f"\tstatic constexpr std::span<const ClassInfo::{element}> {var} {{}};")
+        out.append("#endif")
+    return True
 
+
+def _bind_members_body(c: ClassDesc, dir_name: str) -> list:
+    # Members are emitted as constexpr descriptor arrays that ClassDB references
+    # in place, so registering a class builds no per-member heap state. Unlike
+    # the .gen.h macro, this is a real function body -- #if/#endif can wrap a
+    # conditional entry directly, no hoisted-helper-macro indirection needed.
     out = [f"void {c.name}::_bind_members() {{"]
+
+    properties = []
     for p in c.properties:
         ga = ACCESS_ENUM[p.getter_access]
         sa = ACCESS_ENUM[p.setter_access]
-        has_get = p.getter_kind != "none"
-        has_set = p.setter_kind != "none"
-        if has_get and has_set:
-            emit(out, p.condition, f"\tClassDB::bind_property_accessors_if_bindable("
-                 f"&{c.name}::{p.getter_method}, &{c.name}::{p.setter_method}, "
-                 f'"{p.prop_name}", {ga}, {sa});')
-        elif has_get:
-            emit(out, p.condition, f"\tClassDB::bind_property_get_if_bindable("
-                 f'&{c.name}::{p.getter_method}, "{p.prop_name}", {ga});')
-        elif has_set:
-            emit(out, p.condition, f"\tClassDB::bind_property_set_if_bindable("
-                 f'&{c.name}::{p.setter_method}, "{p.prop_name}", {sa});')
+        getter = _accessor_pointer(c, p, "get")
+        setter = _accessor_pointer(c, p, "set")
+        properties.append((p.condition, f'ClassDB::describe_property<{getter}, {setter}>("{p.prop_name}"_ss, {ga}, {sa})'))
+
+    methods = []
     for m in c.methods:
         acc = ACCESS_ENUM[m.access]
-        if m.is_static:
-            emit(out, m.condition, f'\tClassDB::bind_static_method(&{c.name}::{m.name}, "{m.bind_name}", {acc});')
-        else:
-            bind = "bind_method" if m.strict else "bind_method_if_bindable"
-            emit(out, m.condition, f'\tClassDB::{bind}(&{c.name}::{m.name}, "{m.bind_name}", {acc});')
+        describe = "describe_method" if m.strict or m.is_static else "describe_method_if_bindable"
+        methods.append((m.condition, f'ClassDB::{describe}<&{c.name}::{m.name}>("{m.bind_name}"_ss, {acc})'))
+
+    has_properties = _descriptor_array(out, "Property", "properties", properties)
+    has_methods = _descriptor_array(out, "Method", "methods", methods)
+    if has_properties or has_methods:
+        out.append(f"\tClassDB::bind_descriptors({'properties' if has_properties else '{}'}, "
+                   f"{'methods' if has_methods else '{}'});")
+
     ctx = EmitContext(dir_name=dir_name)
     for modifier, _arg in c.resolved_modifiers:
         for stmt in modifier.bind_members_lines(c, ctx):
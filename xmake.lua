@@ -51,12 +51,22 @@ includes("xmake/public_api.lua")
 -- ---- Core source files ----------------------------------------------------
 -- Mirrors FEATHER_CORE_SOURCES in the old CMakeLists.txt exactly.
 local CORE_SOURCES = {
+    "core/framework/alloc_tracker.cpp",
+    "core/framework/binary_serializer.cpp",
     "core/framework/callable.cpp",
+    "core/framework/io_executor.cpp",
+    "core/framework/job_system.cpp",
+    "core/framework/linear_arena.cpp",
+    "core/framework/mapped_file.cpp",
+    "core/framework/object_pool.cpp",
+    "core/framework/profiler.cpp",
     "core/framework/reflected.cpp",
     "core/framework/shared_library.cpp",
+    "core/framework/static_string.cpp",
     "core/framework/variant.cpp",
     "core/framework/variant_array.cpp",
     "core/main/class_db.cpp",
+    "core/main/member_handle.cpp",
     "core/main/engine.cpp",
     "core/main/engine_settings.cpp",
     "core/main/feather_main.cpp",
@@ -233,6 +243,9 @@ for _, variant in ipairs({"editor", "standalone"}) do
         if is_mode("release") then
             add_defines("PRODUCTION")
         end
+        if has_config("track_allocations") then
+            add_defines("FEATHER_TRACK_ALLOCATIONS")
+        end
 
         add_deps("feather_public_api")
         add_packages("flecs", "assimp", "sdl3", "taywee_args")
@@ -275,6 +288,39 @@ for _, variant in ipairs({"editor", "standalone"}) do
     target_end()
 end
 
+-- ---- Benchmarks ---------------------------------------------------------
+-- feather.bench [filter] runs every FBENCH whose name contains filter. Links
+-- the engine without feather_main.cpp (which has main) and without modules.
+if has_config("build_benchmarks") then
+    target("feather.bench")
+        set_kind("binary")
+        set_targetdir("$(builddir)/bin")
+        for _, file in ipairs(CORE_SOURCES) do
+            if file ~= "core/main/feather_main.cpp" then
+                add_files(file)
+            end
+        end
+        add_files(GENERATED_SOURCE, {always_added=true})
+        add_files("bench/*.cpp")
+        add_includedirs("$(projectdir)", "$(projectdir)/core")
+
+        -- ClassDB's bench hooks (create_for_bench, renumber_class_ids)
+        add_defines("EDITOR_BUILD=0", "FEATHER_BENCH")
+        if is_mode("debug", "releasedbg") then
+            add_defines("BETA")
+        end
+        if is_mode("release") then
+            add_defines("PRODUCTION")
+        end
+
+        add_deps("feather_public_api")
+        add_packages("flecs", "assimp", "sdl3", "taywee_args")
+
+        before_build(run_codegen)
+        on_config(apply_compile_flags)
+    target_end()
+end
+
 -- ---- Modules (auto-discovered; re-opens feather.editor/standalone) ------
 -- Must come after the executor targets so feather_module_target() can
 -- re-open them to add_deps().
@@ -23,6 +23,16 @@ option("enable_sanitizers")
     set_description("Enable AddressSanitizer + UBSan (debug mode + LLVM/Clang only)")
 option_end()
 
+option("track_allocations")
+    set_default(false)
+    set_description("Count heap allocations by subsystem tag (replaces global operator new/delete)")
+option_end()
+
+option("build_benchmarks")
+    set_default(false)
+    set_description("Build feather.bench, the microbenchmark runner (bench/)")
+option_end()
+
 option("enable_clang_tidy")
     set_default(false)
     set_description("Run clang-tidy during compilation (requires compile_commands.json)")